@@ -79,6 +79,7 @@ double bat_gen::LogAPrioriProbability(const std::vector<double>& parameters)
     unsigned c = GetCurrentChain();
     Data_[c].setAll(yap::VariableStatus::changed);
     Data_[c].setAll(yap::CalculationStatus::uncalculated);
-    model()->setFinalStateMomenta(Data_[c][0], P, Data_[c]);
+    auto d = Data_[c][0];
+    model()->setFinalStateMomenta(d, P, Data_[c]);
     return 0;
 }
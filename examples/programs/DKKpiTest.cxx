@@ -86,7 +86,8 @@ int main( int argc, char** argv)
         LOG(INFO) << "... outside phase space";
     else {
         LOG(INFO) << "... inside phase space";
-        M.setFinalStateMomenta(data[0], P, data);
+        auto d = data[0];
+        M.setFinalStateMomenta(d, P, data);
     }
 
     DEBUG("AFTER");
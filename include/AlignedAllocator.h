@@ -0,0 +1,104 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_AlignedAllocator_h
+#define yap_AlignedAllocator_h
+
+#include "MemoryArena.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace yap {
+
+/// \struct AlignedAllocator
+/// \brief Allocator returning memory aligned to #alignment bytes,
+/// for use with std::vector storage that is to be streamed over in vectorized loops.
+/// If given a MemoryArena, memory is carved from it while it has room,
+/// and from the heap afterwards.
+/// \author Johannes Rauch, Daniel Greenwald
+/// \ingroup Data
+template <typename T>
+struct AlignedAllocator {
+
+    /// \typedef value_type
+    using value_type = T;
+
+    /// containers carry their arena along when assigned or swapped
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /// alignment of allocated memory in bytes (one cache line)
+    static constexpr size_t alignment = 64;
+
+    /// Constructor
+    /// \param arena MemoryArena to carve memory from (nullptr for heap)
+    AlignedAllocator(std::shared_ptr<MemoryArena> arena = nullptr)
+        : Arena(arena) {}
+
+    /// converting constructor
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>& other)
+        : Arena(other.Arena) {}
+
+    /// allocate aligned memory for n elements
+    T* allocate(size_t n)
+    {
+        if (Arena) {
+            void* p = Arena->allocate(n * sizeof(T), alignment);
+            if (p)
+                return static_cast<T*>(p);
+        }
+        void* p = nullptr;
+        if (posix_memalign(&p, alignment, n * sizeof(T)) != 0)
+            throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    /// free memory
+    void deallocate(T* p, size_t n)
+    {
+        if (Arena and Arena->owns(p))
+            Arena->deallocate(p, n * sizeof(T));
+        else
+            free(p);
+    }
+
+    /// MemoryArena to carve memory from
+    std::shared_ptr<MemoryArena> Arena;
+};
+
+/// equality operator: allocators are interchangeable if they share an arena
+template <typename T, typename U>
+inline bool operator==(const AlignedAllocator<T>& A, const AlignedAllocator<U>& B)
+{ return A.Arena == B.Arena; }
+
+/// inequality operator
+template <typename T, typename U>
+inline bool operator!=(const AlignedAllocator<T>& A, const AlignedAllocator<U>& B)
+{ return !(A == B); }
+
+}
+
+#endif
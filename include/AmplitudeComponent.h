@@ -22,6 +22,8 @@
 #define yap_AmplitudeComponent_h
 
 #include "fwd/AmplitudeComponent.h"
+
+#include "fwd/AmplitudePlan.h"
 #include "fwd/DataPoint.h"
 #include "fwd/Parameter.h"
 #include "fwd/ParticleCombination.h"
@@ -52,6 +54,12 @@ public:
 
     /// \return a VariableStatus for this AmplitudeComponent
     virtual const VariableStatus status() const = 0;
+
+    /// \return AmplitudeFactor for evaluation in a compiled AmplitudePlan;
+    /// by default, calls #value, should be overriden by components that
+    /// can be read directly from a cached value
+    /// \param pc shared_ptr to ParticleCombination
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc) const;
 };
 
 /// Base class for AmplitudeComponent's that are also StaticDataAccessor's
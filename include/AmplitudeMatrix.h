@@ -0,0 +1,112 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/// \file
+
+#ifndef yap_AmplitudeMatrix_h
+#define yap_AmplitudeMatrix_h
+
+#include "fwd/AmplitudeMatrix.h"
+
+#include "fwd/DataPartition.h"
+#include "fwd/Model.h"
+
+#include "AlignedAllocator.h"
+
+#include <complex>
+#include <vector>
+
+namespace yap {
+
+/// \class AmplitudeMatrix
+/// \brief Data-dependent amplitudes of a Model's DecayTree's over a DataPartition
+/// \author Daniel Greenwald
+/// \ingroup Data
+///
+/// The intensity of a ModelComponent is |sum_k a_k * A_k(d)|^2, with
+/// a_k the data-independent and A_k(d) the data-dependent amplitude
+/// of its k'th DecayTree. For each ModelComponent, this class stores
+/// the A_k(d) for the N DataPoint's of a DataPartition as an N x K
+/// matrix, column by column, so that when only free amplitudes have
+/// changed, the intensity of the partition is a matrix-vector product
+/// requiring no evaluation of the DecayTree's.
+///
+/// #update recalculates only the columns whose DecayTree's depend on
+/// RecalculableDataAccessor's whose parameters have changed since the
+/// column was last calculated (see AmplitudePlan::generation). If the
+/// DataPoint's of the partition change, call #invalidate.
+class AmplitudeMatrix
+{
+public:
+
+    /// \typedef Column
+    /// \brief data-dependent amplitudes of one DecayTree for all DataPoint's
+    using Column = std::vector<std::complex<double>, AlignedAllocator<std::complex<double> > >;
+
+    /// Constructor
+    /// \param M locked Model to calculate amplitudes of
+    /// \param D DataPartition to calculate amplitudes over
+    AmplitudeMatrix(const Model& M, DataPartition& D);
+
+    /// \return Model
+    const Model& model() const
+    { return *Model_; }
+
+    /// \return DataPartition
+    DataPartition& dataPartition() const
+    { return *DataPartition_; }
+
+    /// \return number of rows (DataPoint's)
+    const size_t rows() const
+    { return Rows_; }
+
+    /// \return column of data-dependent amplitudes
+    /// \param c index of ModelComponent
+    /// \param k index of DecayTree within ModelComponent
+    const Column& column(size_t c, size_t k) const
+    { return Columns_[c][k]; }
+
+    /// calculate Model over DataPartition (if needed) and recalculate out-of-date columns
+    /// \param n_threads number of threads to calculate Model with
+    void update(unsigned n_threads = 1);
+
+    /// mark all columns out of date
+    void invalidate();
+
+private:
+
+    /// Model to calculate amplitudes of
+    const Model* Model_;
+
+    /// DataPartition to calculate amplitudes over
+    DataPartition* DataPartition_;
+
+    /// number of rows (DataPoint's)
+    size_t Rows_;
+
+    /// columns of data-dependent amplitudes, by ModelComponent and DecayTree
+    std::vector<std::vector<Column> > Columns_;
+
+    /// generation of parameters each column was last calculated
+    /// with, by ModelComponent and DecayTree
+    std::vector<std::vector<unsigned> > Generations_;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_AmplitudePlan_h
+#define yap_AmplitudePlan_h
+
+#include "fwd/AmplitudePlan.h"
+
+#include "fwd/AmplitudeComponent.h"
+#include "fwd/DataPoint.h"
+#include "fwd/DecayTree.h"
+#include "fwd/FreeAmplitude.h"
+#include "fwd/ParticleCombination.h"
+#include "fwd/RecalculableDataAccessor.h"
+
+#include "CachedValue.h"
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace yap {
+
+/// \class AmplitudeFactor
+/// \brief One factor of a compiled amplitude: a constant, a real or
+/// complex cached value at a fixed symmetrization index, or (as a
+/// fallback) an AmplitudeComponent evaluated for a fixed ParticleCombination
+/// \author Daniel Greenwald
+class AmplitudeFactor
+{
+public:
+
+    /// Constant factor
+    /// \param c value of factor
+    explicit AmplitudeFactor(const std::complex<double>& c) :
+        Type_(Type::constant), Constant_(c), Real_(nullptr), Complex_(nullptr),
+        SymmetrizationIndex_(0), Component_(nullptr) {}
+
+    /// Factor read from a RealCachedValue
+    /// \param v RealCachedValue to read from
+    /// \param sym_index symmetrization index to read
+    AmplitudeFactor(const RealCachedValue& v, unsigned sym_index) :
+        Type_(Type::real), Constant_(1), Real_(&v), Complex_(nullptr),
+        SymmetrizationIndex_(sym_index), Component_(nullptr) {}
+
+    /// Factor read from a ComplexCachedValue
+    /// \param v ComplexCachedValue to read from
+    /// \param sym_index symmetrization index to read
+    AmplitudeFactor(const ComplexCachedValue& v, unsigned sym_index) :
+        Type_(Type::complex), Constant_(1), Real_(nullptr), Complex_(&v),
+        SymmetrizationIndex_(sym_index), Component_(nullptr) {}
+
+    /// Factor calculated by AmplitudeComponent::value
+    /// \param ac AmplitudeComponent to call
+    /// \param pc ParticleCombination to call it for
+    AmplitudeFactor(const AmplitudeComponent& ac, const std::shared_ptr<const ParticleCombination>& pc) :
+        Type_(Type::component), Constant_(1), Real_(nullptr), Complex_(nullptr),
+        SymmetrizationIndex_(0), Component_(&ac), ParticleCombination_(pc) {}
+
+    /// \return whether factor is independent of data
+    const bool isConstant() const
+    { return Type_ == Type::constant; }
+
+    /// \return value of constant factor
+    const std::complex<double>& constant() const
+    { return Constant_; }
+
+    /// \return value of factor
+    /// \param d DataPoint to read from
+    const std::complex<double> value(const DataPoint& d) const
+    {
+        switch (Type_) {
+            case Type::constant:
+                return Constant_;
+            case Type::real:
+                return Real_->value(d, SymmetrizationIndex_);
+            case Type::complex:
+                return Complex_->value(d, SymmetrizationIndex_);
+            default:
+                return componentValue(d);
+        }
+    }
+
+private:
+
+    /// \return value of AmplitudeComponent
+    const std::complex<double> componentValue(const DataPoint& d) const;
+
+    /// type of factor
+    enum class Type {constant, real, complex, component};
+
+    /// type of factor
+    Type Type_;
+
+    /// value of constant factor
+    std::complex<double> Constant_;
+
+    /// RealCachedValue to read from
+    const RealCachedValue* Real_;
+
+    /// ComplexCachedValue to read from
+    const ComplexCachedValue* Complex_;
+
+    /// symmetrization index to read cached value at
+    unsigned SymmetrizationIndex_;
+
+    /// AmplitudeComponent to calculate with
+    const AmplitudeComponent* Component_;
+
+    /// ParticleCombination to calculate AmplitudeComponent for
+    std::shared_ptr<const ParticleCombination> ParticleCombination_;
+
+};
+
+/// \class AmplitudePlan
+/// \brief Flat evaluation plan for the amplitude of a DecayTreeVector
+/// \author Daniel Greenwald
+///
+/// A DecayTree's data-dependent amplitude is a sum over the
+/// ParticleCombination's of its DecayChannel of products of its
+/// SpinAmplitude, its AmplitudeComponent's, and the data-dependent
+/// amplitudes of its daughters' DecayTree's. Compiling resolves this
+/// recursion once into a flat list of terms. Each term is a constant
+/// times a contiguous range of AmplitudeFactor's, so evaluation needs
+/// no map lookups, recursion, or virtual calls. The plan must be
+/// compiled after the Model has assigned indices to its
+/// DataAccessor's and should be used only with a locked Model.
+class AmplitudePlan
+{
+public:
+
+    /// Default constructor, for empty plan
+    AmplitudePlan() = default;
+
+    /// Constructor, compiles plan
+    /// \param dtv DecayTreeVector to compile plan for
+    explicit AmplitudePlan(const DecayTreeVector& dtv);
+
+    /// \return number of decay trees in plan
+    const size_t size() const
+    { return FreeAmplitudes_.size(); }
+
+    /// \return free amplitudes multiplying i'th decay tree, including repeats
+    /// \param i index of decay tree
+    const FreeAmplitudeVector& freeAmplitudes(size_t i) const
+    { return FreeAmplitudes_[i]; }
+
+    /// \return sum of generations of the RecalculableDataAccessor's the
+    /// data-dependent amplitude of the i'th decay tree depends on, which
+    /// changes whenever any of their parameters changes
+    /// \param i index of decay tree
+    const unsigned generation(size_t i) const;
+
+    /// \return data-independent amplitudes of decay trees, in order of compiled DecayTreeVector
+    std::vector<std::complex<double> > dataIndependentAmplitudes() const;
+
+    /// \return data-dependent amplitude of i'th decay tree
+    /// \param d DataPoint to evaluate on
+    /// \param i index of decay tree
+    const std::complex<double> dataDependentAmplitude(const DataPoint& d, size_t i) const;
+
+    /// \return amplitude summed over decay trees
+    /// \param d DataPoint to evaluate on
+    /// \param A data-independent amplitudes, as returned by #dataIndependentAmplitudes
+    const std::complex<double> amplitude(const DataPoint& d, const std::vector<std::complex<double> >& A) const;
+
+    /// \return amplitude summed over decay trees
+    /// \param d DataPoint to evaluate on
+    const std::complex<double> amplitude(const DataPoint& d) const
+    { return amplitude(d, dataIndependentAmplitudes()); }
+
+private:
+
+    /// compile data-dependent factors of decay tree for particle combination into plan
+    /// \param dt DecayTree to compile
+    /// \param pc ParticleCombination to compile for
+    /// \param c constant factor of term, accumulated over constant factors
+    void compile(const DecayTree& dt, const std::shared_ptr<const ParticleCombination>& pc, std::complex<double>& c);
+
+    /// \struct Term
+    /// \brief product of a constant and a range of factors
+    struct Term
+    {
+        /// constant factor
+        std::complex<double> Constant;
+        /// index of first factor in Factors_
+        size_t Begin;
+        /// index past last factor in Factors_
+        size_t End;
+    };
+
+    /// factors of all terms
+    std::vector<AmplitudeFactor> Factors_;
+
+    /// terms of all decay trees
+    std::vector<Term> Terms_;
+
+    /// index of first term in Terms_ for each decay tree, and one past last term
+    std::vector<size_t> TermOffsets_;
+
+    /// free amplitudes multiplying each decay tree
+    std::vector<FreeAmplitudeVector> FreeAmplitudes_;
+
+    /// RecalculableDataAccessor's (and those they depend on) among
+    /// amplitude components of each decay tree and its daughters
+    std::vector<std::vector<const RecalculableDataAccessor*> > RecalculableDataAccessors_;
+
+};
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 #ifndef yap_BlattWeisskopf_h
 #define yap_BlattWeisskopf_h
 
+#include "fwd/AmplitudePlan.h"
 #include "fwd/DataPartition.h"
 #include "fwd/DataPoint.h"
 #include "fwd/DecayingParticle.h"
@@ -59,6 +60,10 @@ public:
     /// \param pc shared_ptr to ParticleCombination
     virtual const std::complex<double> value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const override;
 
+    /// \return AmplitudeFactor reading the cached barrier factor, or constant 1 for L = 0
+    /// \param pc shared_ptr to ParticleCombination
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc) const override;
+
     /// Calculate barrier factors for and store into each data point in a data partition
     /// \param D DataPartition to calculate over
     virtual void calculate(DataPartition& D) const override;
@@ -93,11 +98,66 @@ private:
 
 };
 
-/// squared Blatt-Weisskopf barrier factor;
+/// squared Blatt-Weisskopf barrier factor, evaluated exactly for any l
+/// by recursion of the spherical Hankel functions:
+/// \f$ F^{2}_{l}(z) = |h_{l}(1)|^2 / (z |h_{l}(\sqrt{z})|^2) \f$
+/// \param l Orbital angular momentum
+/// \param z squared breakup momentum * squared radius
+const double hankel_squared_barrier_factor(unsigned l, double z);
+
+/// squared Blatt-Weisskopf barrier factor for fixed orbital angular momentum;
+/// specialized to closed-form expressions for L < 8
+/// \tparam L Orbital angular momentum
+/// \param z squared breakup momentum * squared radius
+template <unsigned L>
+inline const double squared_barrier_factor(double z)
+{ return hankel_squared_barrier_factor(L, z); }
+
+template <>
+inline const double squared_barrier_factor<0>(double z)
+{ return 1; }
+
+template <>
+inline const double squared_barrier_factor<1>(double z)
+{ return 2 * z / (z + 1); }
+
+template <>
+inline const double squared_barrier_factor<2>(double z)
+{ return 13 * z * z / (z * (z + 3) + 9); }
+
+template <>
+inline const double squared_barrier_factor<3>(double z)
+{ return 277 * z * z * z / (z * (z * (z + 6) + 45) + 225); }
+
+template <>
+inline const double squared_barrier_factor<4>(double z)
+{ double z2 = z * z; return 12746 * z2 * z2 / (z * (z * (z * (z + 10) + 135) + 1575) + 11025); }
+
+template <>
+inline const double squared_barrier_factor<5>(double z)
+{ double z2 = z * z; return 998881 * z2 * z2 * z / (z * (z * (z * (z * (z + 15) + 315) + 6300) + 99225) + 893025); }
+
+template <>
+inline const double squared_barrier_factor<6>(double z)
+{ double z3 = z * z * z; return 118394977 * z3 * z3 / (z * (z * (z * (z * (z * (z + 21) + 630) + 18900) + 496125) + 9823275) + 108056025); }
+
+template <>
+inline const double squared_barrier_factor<7>(double z)
+{ double z3 = z * z * z; return 19727003738. * z3 * z3 * z / (z * (z * (z * (z * (z * (z * (z + 28) + 1134) + 47250) + 1819125) + 58939650) + 1404728325.) + 18261468225.); }
+
+/// squared Blatt-Weisskopf barrier factor
 /// \param l Orbital angular momentum
-/// \param z squared breakup momentum / squared radius
-/// \warning approximate result for l >= 8 is not properly tested, nor streamlined!
+/// \param z squared breakup momentum * squared radius
 const double squared_barrier_factor(unsigned l, double z);
+
+/// squared Blatt-Weisskopf barrier factors for an array of values of z,
+/// dispatching on l once for the whole array
+/// \param l Orbital angular momentum
+/// \param F2 array of (at least) n values to fill
+/// \param z array of squared breakup momenta * squared radius
+/// \param n number of values
+void squared_barrier_factors(unsigned l, double* F2, const double* z, size_t n);
+
 }
 
 #endif
@@ -26,6 +26,7 @@
 #include "fwd/DecayChannel.h"
 #include "fwd/ParticleCombination.h"
 #include "fwd/ParticleTable.h"
+#include "fwd/RecalculableDataAccessor.h"
 
 #include "ConstantWidthBreitWigner.h"
 
@@ -62,13 +63,8 @@ public:
     /// Cheks that decay is to two spin-zero particles
     virtual void checkDecayChannel(const DecayChannel& c) const override;
 
-    using ConstantWidthBreitWigner::calculate;
-    
-    /// Calculate dynamic amplitude T for and store in each DataPoint in DataPartition
-    /// \param D DataPartition to calculate on
-    /// \param pc ParticleCombination to calculate for
-    /// \param si SymmetrizationIndec to calculate for
-    virtual void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const override;
+    /// \return BlattWeisskopf_, which must be calculated before this
+    virtual RecalculableDataAccessorSet dependencies() const override;
 
     // \return BlattWiesskopf_
     const std::shared_ptr<const BlattWeisskopf> blattWeisskopf() const
@@ -76,6 +72,23 @@ public:
     
 protected:
 
+    /// Calculate dynamic amplitudes for a batch of data points
+    /// \param B MassShapeBatch holding masses, whose amplitudes T to fill
+    /// \param first iterator to first data point of batch
+    /// \param pc ParticleCombination to calculate for
+    virtual void calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const override;
+
+    /// \return true, since width depends on daughter masses
+    virtual bool requiresDaughterMasses() const override
+    { return true; }
+
+    /// gather squared Blatt-Weisskopf barrier factors of a batch of data points
+    /// \param F2 array of (at least) n values to fill
+    /// \param first iterator to first data point of batch
+    /// \param n number of data points
+    /// \param pc ParticleCombination to gather for
+    void squaredBarrierFactors(double* F2, DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc) const;
+
     /// Retrieve BlattWeisskopf object from owner now that it is added to the Model
     virtual void addDecayChannel(std::shared_ptr<DecayChannel> c) override;
 
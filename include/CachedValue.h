@@ -31,8 +31,11 @@
 
 #include "DataAccessor.h"
 #include "DataPoint.h"
+#include "StoragePrecision.h"
 
+#include <algorithm>
 #include <complex>
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <string>
@@ -53,7 +56,8 @@ protected:
     /// Constructor (protected)
     /// \param size number of real elements in cached value
     /// \param da DataAccessor it to belong to
-    CachedValue(unsigned size, DataAccessor& da);
+    /// \param precision StoragePrecision of elements
+    CachedValue(unsigned size, DataAccessor& da, StoragePrecision precision);
 
 public:
 
@@ -63,6 +67,11 @@ public:
         /// constructor
         Status();
 
+        /// constructor
+        /// \param c CalculationStatus
+        /// \param v VariableStatus
+        Status(CalculationStatus c, VariableStatus v) : Calculation(c), Variable(v) {}
+
         /// Calculation status
         CalculationStatus Calculation;
 
@@ -89,13 +98,57 @@ public:
     const int index() const
     { return Index_; }
 
+    /// \return position of first element within owner's storage
+    const int position() const
+    { return Position_; }
+
+    /// \return position of status for first symmetrization index in a StatusManager
+    const unsigned statusOffset() const
+    { return StatusOffset_; }
+
+    /// \return index of column in a DataSet's DataColumns
+    /// \param sym_index index of symmetrization
+    /// \param index index of element within cached value
+    const unsigned column(unsigned sym_index, unsigned index = 0) const
+    { return Column_ + sym_index * ColumnStride_ + index; }
+
+    /// \return StoragePrecision of elements
+    const StoragePrecision precision() const
+    { return Precision_; }
+
+    /// \return bound on magnitude of elements (0 if unknown)
+    const double bound() const
+    { return Bound_; }
+
+    /// \return StoragePrecision with which elements are stored in DataColumns of precision p
+    const StoragePrecision storagePrecision(StoragePrecision p) const
+    {
+        p = std::min(Precision_, p);
+        return (p == StoragePrecision::fixed_point and Bound_ <= 0) ? StoragePrecision::single_precision : p;
+    }
+
+    /// \return largest absolute error of elements due to storing them as
+    /// fixed point in DataColumns of precision p (0 if not stored as fixed point)
+    const double quantizationError(StoragePrecision p) const
+    { return storagePrecision(p) == StoragePrecision::fixed_point ? fixed_point_error(Bound_) : 0; }
+
     /// Get value from #DataPoint for particular symmetrization
     /// \param index index of value to get from within cached value (must be less than #Size_)
     /// \param d #DataPoint to get value from
     /// \param sym_index index of symmetrization to grab from
     /// \return Value of CachedValue inside the data point
     inline const double value(unsigned index, const DataPoint& d, unsigned sym_index) const
-    { return d.Data_[Owner_->index()][sym_index * Owner_->size() + Position_ + index]; }
+    {
+        const void* c = static_cast<const DataColumns*>(d.Columns_)->column(column(sym_index, index));
+        switch (storagePrecision(d.Columns_->precision())) {
+            case StoragePrecision::fixed_point:
+                return from_fixed_point(static_cast<const int16_t*>(c)[d.Row_], Bound_);
+            case StoragePrecision::single_precision:
+                return static_cast<const float*>(c)[d.Row_];
+            default:
+                return static_cast<const double*>(c)[d.Row_];
+        }
+    }
 
     /// \return Size of cached value (number of real elements)
     virtual const unsigned size() const
@@ -113,7 +166,25 @@ public:
     /// \param d #DataPoint to update
     /// \param sym_index index of symmetrization to apply to
     void setValue(unsigned index, double val, DataPoint& d, unsigned sym_index) const
-    { d.Data_[Owner_->index()][sym_index * Owner_->size() + Position_ + index] = val; }
+    {
+        void* c = d.Columns_->column(column(sym_index, index));
+        switch (storagePrecision(d.Columns_->precision())) {
+            case StoragePrecision::fixed_point:
+                static_cast<int16_t*>(c)[d.Row_] = to_fixed_point(val, Bound_);
+                break;
+            case StoragePrecision::single_precision:
+                static_cast<float*>(c)[d.Row_] = val;
+                break;
+            default:
+                static_cast<double*>(c)[d.Row_] = val;
+        }
+    }
+
+    /// set bound on magnitude of all elements, which allows them to be
+    /// stored as fixed point; must be set before DataSet's are created
+    /// \param b bound (0 if unknown)
+    void setBound(double b)
+    { Bound_ = b; }
 
     /// @}
 
@@ -133,6 +204,29 @@ protected:
     void setPosition(int p)
     { Position_ = p; }
 
+    /// set position of status for first symmetrization index in a StatusManager
+    void setStatusOffset(unsigned o)
+    { StatusOffset_ = o; }
+
+    /// set columns in DataColumns
+    /// \param c column of first element for first symmetrization index
+    /// \param stride number of columns between symmetrization indices
+    void setColumns(unsigned c, unsigned stride)
+    { Column_ = c; ColumnStride_ = stride; }
+
+    /// \return val as it would be read back after being stored in a DataPoint
+    const double stored(double val, const DataPoint& d) const
+    {
+        switch (storagePrecision(d.Columns_->precision())) {
+            case StoragePrecision::fixed_point:
+                return from_fixed_point(to_fixed_point(val, Bound_), Bound_);
+            case StoragePrecision::single_precision:
+                return static_cast<float>(val);
+            default:
+                return val;
+        }
+    }
+
 private:
 
     /// Owning DataAccessor
@@ -144,9 +238,24 @@ private:
     /// Position of first element of cached value within data vector
     int Position_;
 
+    /// position of status for first symmetrization index in a StatusManager
+    unsigned StatusOffset_;
+
+    /// column of first element for first symmetrization index in DataColumns
+    unsigned Column_;
+
+    /// number of columns between symmetrization indices in DataColumns
+    unsigned ColumnStride_;
+
     /// Size of cached value (number of real elements)
     unsigned Size_;
 
+    /// Precision with which elements are stored
+    StoragePrecision Precision_;
+
+    /// bound on magnitude of elements (0 if unknown)
+    double Bound_;
+
 };
 
 /// equality operator for checking the CalculationStatus
@@ -178,13 +287,14 @@ class RealCachedValue : public CachedValue
 private:
 
     /// Constructor
-    RealCachedValue(DataAccessor& da) : CachedValue(1, da) {}
+    RealCachedValue(DataAccessor& da, StoragePrecision precision) : CachedValue(1, da, precision) {}
 
 public:
 
     /// create shared_ptr to RealCachedValue
     /// \param owner #DataAccessor to which this cached value belongs
-    static std::shared_ptr<RealCachedValue> create(DataAccessor& da);
+    /// \param precision StoragePrecision of value
+    static std::shared_ptr<RealCachedValue> create(DataAccessor& da, StoragePrecision precision = StoragePrecision::double_precision);
 
     /// Set value into #DataPoint for particular symmetrization, and
     /// update VariableStatus for symm. and partition index
@@ -222,13 +332,14 @@ private:
 
     /// Constructor (protected)
     /// see #create for details
-    ComplexCachedValue(DataAccessor& da) : CachedValue(2, da) {}
+    ComplexCachedValue(DataAccessor& da, StoragePrecision precision) : CachedValue(2, da, precision) {}
 
 public:
 
     /// create shared pointer to ComplexCachedValue
     /// \param owner #DataAccessor to which this cached value belongs
-    static std::shared_ptr<ComplexCachedValue> create(DataAccessor& da);
+    /// \param precision StoragePrecision of real and imaginary parts
+    static std::shared_ptr<ComplexCachedValue> create(DataAccessor& da, StoragePrecision precision = StoragePrecision::double_precision);
 
     /// Set value into #DataPoint for particular symmetrization, and
     /// update VariableStatus for symm. and partition index
@@ -285,13 +396,14 @@ private:
 
     /// Constructor (protected)
     /// see #create for details
-    FourVectorCachedValue(DataAccessor& da) : CachedValue(4, da) {}
+    FourVectorCachedValue(DataAccessor& da, StoragePrecision precision) : CachedValue(4, da, precision) {}
 
 public:
 
     /// create shared pointer to ComplexCachedValue
     /// \param owner #DataAccessor to which this cached value belongs
-    static std::shared_ptr<FourVectorCachedValue> create(DataAccessor& da);
+    /// \param precision StoragePrecision of components
+    static std::shared_ptr<FourVectorCachedValue> create(DataAccessor& da, StoragePrecision precision = StoragePrecision::double_precision);
 
     /// Set value into #DataPoint for particular symmetrization, and
     /// update VariableStatus for symm. and partition index
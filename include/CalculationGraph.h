@@ -0,0 +1,86 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_CalculationGraph_h
+#define yap_CalculationGraph_h
+
+#include "fwd/CalculationGraph.h"
+
+#include "fwd/DataPartition.h"
+#include "fwd/RecalculableDataAccessor.h"
+
+#include <vector>
+
+namespace yap {
+
+/// \class CalculationGraph
+/// \brief Directed acyclic graph of the dependencies among a Model's RecalculableDataAccessor's
+/// \author Johannes Rauch, Daniel Greenwald
+///
+/// Each RecalculableDataAccessor declares through
+/// RecalculableDataAccessor::dependencies which others must be calculated
+/// before it. The graph is built once, when the Model is locked, and
+/// executed as a task graph: an accessor is calculated as soon as all it
+/// depends on is, and accessors not depending on each other (e.g. the
+/// mass shapes of different resonances) may be calculated concurrently
+/// over the same DataPartition.
+class CalculationGraph
+{
+public:
+
+    /// Default constructor: empty graph
+    CalculationGraph() = default;
+
+    /// Constructor; throws if a dependency is not in rdas, or if dependencies are cyclic
+    /// \param rdas RecalculableDataAccessor's to build graph of
+    explicit CalculationGraph(const RecalculableDataAccessorSet& rdas);
+
+    /// calculate all RecalculableDataAccessor's over a DataPartition
+    /// \param D DataPartition to calculate over
+    /// \param n_threads maximum number of accessors to calculate concurrently
+    void calculate(DataPartition& D, unsigned n_threads = 1) const;
+
+    /// \return RecalculableDataAccessor's in an order in which they may be calculated serially
+    const RecalculableDataAccessorVector& order() const
+    { return Order_; }
+
+    /// \return number of RecalculableDataAccessor's in graph
+    size_t size() const
+    { return Order_.size(); }
+
+    /// \return length of longest chain of dependencies (number of accessors in it)
+    unsigned depth() const;
+
+private:
+
+    /// RecalculableDataAccessor's in topological order
+    RecalculableDataAccessorVector Order_;
+
+    /// indices into Order_ of the accessors depending on each accessor
+    std::vector<std::vector<unsigned> > Dependents_;
+
+    /// number of accessors each accessor depends on
+    std::vector<unsigned> NDependencies_;
+
+};
+
+}
+
+#endif
@@ -66,7 +66,8 @@ inline const bool nonzeroCoefficient(unsigned two_j1, int two_m1, unsigned two_j
 { return nonzeroCoefficient(two_j1, two_m1, two_j2, two_m2, two_J, two_m1 + two_m2); }
 
 /// \return Clebsch-Gordan coefficient (j1 m1 j2 m2 | J M)
-/// Implemented from Eq. (16) from G. Racah, "Theory of Complex Spectra. II", Phys. Rev. 62, 438 (1942)
+/// Implemented from Eq. (16) from G. Racah, "Theory of Complex Spectra. II", Phys. Rev. 62, 438 (1942).
+/// Nonzero coefficients are memoized on first calculation; thread safe.
 /// \param two_j1 2*spin of first particle
 /// \param two_m1 2*spin-projection of first particle
 /// \param two_j2 2*spin of second particle
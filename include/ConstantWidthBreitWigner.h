@@ -62,33 +62,16 @@ public:
     const std::shared_ptr<PositiveRealParameter> width() const
     { return const_cast<ConstantWidthBreitWigner*>(this)->width(); }
 
-    /// update the calculationStatus for a DataPartition
-    virtual void updateCalculationStatus(StatusManager& D) const override;
-    
-    /// \return value for DataPoint and ParticleCombination
-    /// \param d DataPoint
-    /// \param pc shared_ptr to ParticleCombination
-    virtual const std::complex<double> value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const override;
-
-    using MassShapeWithNominalMass::calculate;
-    
-    /// Calculate dynamic amplitude T for particular particle combination and store in each DataPoint in DataPartition
-    /// \param D DataPartition to calculate on
-    /// \param pc ParticleCombination to calculate for
-    /// \param si SymmetrizationIndec to calculate for
-    virtual void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const override;
-
 protected:
 
-    /// access cached dynamic amplitude
-    const std::shared_ptr<ComplexCachedValue> T() const
-    { return T_; }
+    /// Calculate dynamic amplitudes for a batch of data points
+    /// \param B MassShapeBatch holding masses, whose amplitudes T to fill
+    /// \param first iterator to first data point of batch
+    /// \param pc ParticleCombination to calculate for
+    virtual void calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const override;
 
 private:
 
-    /// cached dynamic amplitude
-    std::shared_ptr<ComplexCachedValue> T_;
-
     /// Width [GeV]
     std::shared_ptr<PositiveRealParameter> Width_;
 
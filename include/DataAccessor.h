@@ -28,7 +28,10 @@
 #include "fwd/Model.h"
 #include "fwd/ParticleCombination.h"
 
+#include "ParticleCombination.h"
+
 #include <memory>
+#include <vector>
 
 namespace yap {
 
@@ -54,9 +57,18 @@ public:
     int index() const
     { return Index_; }
 
+    /// \return index inside row of DataPoint for the requested ParticleCombination;
+    /// in constant time, by the ParticleCombination's index, once the Model is locked
+    unsigned symmetrizationIndex(const ParticleCombination& c) const
+    {
+        return (c.index() >= 0 and c.index() < (int)SymmetrizationIndexTable_.size() and SymmetrizationIndexTable_[c.index()] >= 0)
+            ? SymmetrizationIndexTable_[c.index()]
+            : SymmetrizationIndices_.at(c.shared_from_this());
+    }
+
     /// \return index inside row of DataPoint for the requested ParticleCombination
     unsigned symmetrizationIndex(const std::shared_ptr<const ParticleCombination>& c) const
-    { return SymmetrizationIndices_.at(c); }
+    { return symmetrizationIndex(*c); }
 
     /// \return SymmetrizationIndices_
     const ParticleCombinationMap<unsigned>& symmetrizationIndices() const
@@ -74,6 +86,18 @@ public:
     const unsigned size() const
     { return Size_; }
 
+    /// \return position of first status of first CachedValue in a StatusManager
+    const unsigned statusOffset() const
+    { return StatusOffset_; }
+
+    /// \return index of first column of this DataAccessor in a DataSet's DataColumns
+    const unsigned columnOffset() const
+    { return ColumnOffset_; }
+
+    /// \return number of statuses of all CachedValue's in a StatusManager
+    const unsigned nStatuses() const
+    { return CachedValues_.size() * NIndices_; }
+
     /// \return whether DataAccessor stores any data
     const bool requiresStorage() const
     { return size() > 0 and nSymmetrizationIndices() > 0; }
@@ -108,6 +132,20 @@ protected:
     void setIndex(size_t i)
     { Index_ = i; }
 
+    /// set positions of statuses of CachedValue's in StatusManager's,
+    /// ordered by CachedValue, then symmetrization index
+    /// \param o position of first status
+    void setStatusOffset(unsigned o);
+
+    /// set index of first column in DataColumns, and the columns of CachedValue's
+    /// \param o index of first column
+    void setColumnOffset(unsigned o);
+
+    /// fill table of symmetrization indices by ParticleCombination index,
+    /// to be called once ParticleCombination indices are assigned
+    /// \param n number of ParticleCombination indices
+    void tabulateSymmetrizationIndices(unsigned n);
+
 private:
 
     /// Increase storage
@@ -121,6 +159,9 @@ private:
     /// Map of indices for each used symmetrization stored with key = shared_ptr<ParticleCombination>
     ParticleCombinationMap<unsigned> SymmetrizationIndices_;
 
+    /// symmetrization indices by ParticleCombination index (-1 if not stored)
+    std::vector<int> SymmetrizationIndexTable_;
+
     /// Number of independent indices stored in SymmetrizationIndices_
     unsigned NIndices_;
 
@@ -133,6 +174,12 @@ private:
     /// storage index used in DataPoint. Must be unique.
     int Index_;
 
+    /// position of first status in StatusManager's
+    unsigned StatusOffset_;
+
+    /// index of first column in DataColumns
+    unsigned ColumnOffset_;
+
 };
 
 /// remove expired elements of set
@@ -0,0 +1,246 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_DataColumns_h
+#define yap_DataColumns_h
+
+#include "fwd/DataColumns.h"
+
+#include "fwd/DataAccessor.h"
+#include "fwd/MemoryArena.h"
+#include "fwd/StoragePrecision.h"
+
+#include "AlignedAllocator.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace yap {
+
+/// \class DataColumns
+/// \brief Columnar (structure-of-arrays) storage for the cached values of a set of data points
+/// \author Johannes Rauch, Daniel Greenwald
+/// \ingroup Data
+///
+/// Every real element of every symmetrization index of every
+/// DataAccessor is a column: a contiguous array over all rows, of
+/// 16-bit fixed point, float, or double as set by the StoragePrecision of
+/// the CachedValue it belongs to, capped by the precision of the
+/// DataColumns object itself. Columns lie back to back in one buffer and start on
+/// AlignedAllocator::alignment-byte boundaries, so that loops over the
+/// rows of a column stream through memory.
+///
+/// Columns can also be mapped from external memory (see #map), e.g.
+/// from a StaticDataCache file. Mapped columns are only ever read; they are
+/// copied into the buffer before anything is written to any column,
+/// and when the DataColumns object is copied.
+class DataColumns
+{
+public:
+
+    /// Constructor, creates empty columns
+    /// \param sDA DataAccessorSet to take column structure from
+    /// \param precision maximum StoragePrecision of columns
+    /// \param arena MemoryArena to carve storage from (nullptr for heap)
+    explicit DataColumns(const DataAccessorSet& sDA, StoragePrecision precision,
+                         std::shared_ptr<MemoryArena> arena = nullptr);
+
+    /// copy constructor
+    DataColumns(const DataColumns& other);
+
+    /// move constructor
+    DataColumns(DataColumns&&) = default;
+
+    /// copy assignment operator
+    DataColumns& operator=(const DataColumns& other)
+    { return *this = DataColumns(other); }
+
+    /// move assignment operator
+    DataColumns& operator=(DataColumns&&) = default;
+
+    /// \return maximum StoragePrecision of columns
+    const StoragePrecision precision() const
+    { return Precision_; }
+
+    /// \return MemoryArena storage is carved from (nullptr if heap)
+    std::shared_ptr<MemoryArena> arena() const
+    { return Data_.get_allocator().Arena; }
+
+    /// \return number of data accessors
+    size_t nDataAccessors() const
+    { return Offsets_.size() - 1; }
+
+    /// \return total number of columns
+    unsigned nColumns() const
+    { return Offsets_.back(); }
+
+    /// \return index of first column of DataAccessor
+    /// \param da index of DataAccessor
+    unsigned offset(unsigned da) const
+    { return Offsets_[da]; }
+
+    /// \return number of bytes of one element of column j
+    size_t width(unsigned j) const
+    { return ByteOffsets_[j + 1] - ByteOffsets_[j]; }
+
+    /// \return number of bytes of one row
+    size_t rowBytes() const
+    { return ByteOffsets_.back(); }
+
+    /// \return number of rows
+    size_t size() const
+    { return Size_; }
+
+    /// \return number of rows that can be held in currently allocated storage
+    size_t capacity() const
+    { return Capacity_; }
+
+    /// \return maximum number of rows that can be stored
+    size_t max_size() const
+    { return Data_.max_size() / std::max<size_t>(rowBytes(), 1); }
+
+    /// \return size of stored rows in bytes
+    size_t bytes() const
+    { return Size_ * rowBytes(); }
+
+    /// \return pointer to first element of column, copying mapped columns into own storage if column is mapped,
+    /// to be cast to pointer to int16_t, float, or double according to precision of column
+    /// \param da index of DataAccessor
+    /// \param i index of column within DataAccessor (symIndex * size + position)
+    void* column(unsigned da, unsigned i)
+    { return column(Offsets_[da] + i); }
+
+    /// \return pointer to first element of column (const),
+    /// to be cast to pointer to int16_t, float, or double according to precision of column
+    /// \param da index of DataAccessor
+    /// \param i index of column within DataAccessor (symIndex * size + position)
+    const void* column(unsigned da, unsigned i) const
+    { return Columns_[Offsets_[da] + i]; }
+
+    /// \return pointer to first element of column, copying mapped columns into own storage if column is mapped,
+    /// to be cast to pointer to int16_t, float, or double according to precision of column
+    /// \param j index of column among all columns (see CachedValue::column)
+    void* column(unsigned j)
+    { if (!Mapped_.empty() and Mapped_[j]) materialize(); return Columns_[j]; }
+
+    /// \return pointer to first element of column (const),
+    /// to be cast to pointer to int16_t, float, or double according to precision of column
+    /// \param j index of column among all columns (see CachedValue::column)
+    const void* column(unsigned j) const
+    { return Columns_[j]; }
+
+    /// \return whether any columns are mapped from external memory
+    bool mapped() const
+    { return !Mapped_.empty(); }
+
+    /// reserve storage for n rows
+    void reserve(size_t n);
+
+    /// resize to n rows; new rows are zeroed
+    void resize(size_t n);
+
+    /// replace contents by n rows, taking some columns from external
+    /// memory without copying them; all other columns are zeroed.
+    /// External memory is only read: mapped columns are copied into own storage before any column is written to.
+    /// \param n number of rows
+    /// \param columns pointer to first of n elements of each column (indexed as in #offset);
+    /// nullptr for columns held in own storage
+    /// \param mapping object keeping the external memory alive
+    void map(size_t n, const std::vector<const void*>& columns, std::shared_ptr<const void> mapping);
+
+    /// remove all rows; keeps allocated storage
+    void clear()
+    { Size_ = 0; }
+
+    /// release storage not needed by current rows
+    void shrink_to_fit();
+
+    /// insert n zeroed rows before row pos
+    void insert(size_t pos, size_t n = 1);
+
+    /// erase rows [first, last)
+    void erase(size_t first, size_t last);
+
+    /// copy a row from another DataColumns object (or from this one)
+    /// \param row row to copy into
+    /// \param src DataColumns to copy from
+    /// \param src_row row in src to copy from
+    void copy(size_t row, const DataColumns& src, size_t src_row);
+
+    /// check that two DataColumns have same internal structure
+    friend bool equalStructure(const DataColumns& A, const DataColumns& B)
+    { return A.Precision_ == B.Precision_ and A.Offsets_ == B.Offsets_ and A.ByteOffsets_ == B.ByteOffsets_; }
+
+    /// check that a row of A equals a row of B
+    friend bool equalRows(const DataColumns& A, size_t a, const DataColumns& B, size_t b);
+
+private:
+
+    /// \return pointer to first byte of column j
+    unsigned char* columnBytes(unsigned j)
+    { return Columns_[j]; }
+
+    /// \return pointer to first byte of column j (const)
+    const unsigned char* columnBytes(unsigned j) const
+    { return Columns_[j]; }
+
+    /// move all columns, including mapped ones, into a buffer of capacity c
+    void reallocate(size_t c);
+
+    /// copy mapped columns into own storage, to be called before writing to any column
+    void materialize()
+    { if (mapped()) reallocate(Capacity_); }
+
+    /// maximum StoragePrecision of columns
+    StoragePrecision Precision_;
+
+    /// index of first column of each DataAccessor;
+    /// last element is total number of columns
+    std::vector<unsigned> Offsets_;
+
+    /// sum of element sizes of all columns before each column;
+    /// unless mapped, a column starts at ByteOffsets_[j] * Capacity_ in Data_;
+    /// last element is number of bytes of one row
+    std::vector<size_t> ByteOffsets_;
+
+    /// number of rows
+    size_t Size_;
+
+    /// number of rows allocated per column
+    size_t Capacity_;
+
+    /// storage for all columns not mapped
+    std::vector<unsigned char, AlignedAllocator<unsigned char> > Data_;
+
+    /// pointer to first element of each column, in Data_ or in mapped memory
+    std::vector<unsigned char*> Columns_;
+
+    /// whether each column is mapped; empty if none are
+    std::vector<bool> Mapped_;
+
+    /// object keeping mapped memory alive (nullptr if nothing is mapped)
+    std::shared_ptr<const void> Mapping_;
+
+};
+
+}
+
+#endif
@@ -23,9 +23,9 @@
 
 #include "fwd/DataPartition.h"
 
-#include "fwd/DataPoint.h"
 #include "fwd/DataSet.h"
 
+#include "DataPoint.h"
 #include "StatusManager.h"
 
 #include <iterator>
@@ -47,9 +47,9 @@ protected:
 
     /// constructor
     /// \param p owning DataPartition
-    /// \param it vector<DataPoint> iterator to contain
-    DataIterator(const DataPartition& p, DataPointVector::iterator it)
-        : Partition_(&p), Iterator_(it) {}
+    /// \param d DataPoint to point at
+    DataIterator(const DataPartition& p, const DataPoint& d)
+        : Partition_(&p), Point_(d) {}
 
 public:
 
@@ -83,16 +83,18 @@ public:
     friend const DataIterator::difference_type operator-(const DataIterator& lhs, const DataIterator& rhs);
 
     /// dereference operator
+    /// \attention reference is to a row handle held by the iterator,
+    /// and so is only valid until the iterator is changed
     DataPoint& operator*()
-    { return *Iterator_; }
+    { return Point_; }
 
     /// dereference operator (const)
     const DataPoint& operator*() const
-    { return *Iterator_; }
+    { return Point_; }
 
     /// pointer operator
-    DataPoint operator->()
-    { return *(this->Iterator_).operator->(); }
+    DataPoint* operator->()
+    { return &Point_; }
 
     /// check ownership
     bool ownedBy(const DataPartition& dp) const
@@ -100,21 +102,21 @@ public:
 
     /// less-than operator
     friend const bool operator<(const DataIterator& lhs, const DataIterator& rhs)
-    { return lhs.Iterator_ < rhs.Iterator_; }
+    { return lhs.Point_.row() < rhs.Point_.row(); }
 
     /// greater-than operator
     friend const bool operator>(const DataIterator& lhs, const DataIterator& rhs)
-    { return lhs.Iterator_ > rhs.Iterator_; }
+    { return lhs.Point_.row() > rhs.Point_.row(); }
 
     /// equality operator
     friend const bool operator==(const DataIterator& lhs, const DataIterator& rhs)
-    { return lhs.Iterator_ == rhs.Iterator_; }
+    { return lhs.Point_.row() == rhs.Point_.row(); }
 
     /// access operator
     DataPoint operator[](DataIterator::difference_type n) const
-    { return *(Iterator_ + n); }
+    { DataPoint d(Point_); d.Row_ += n; return d; }
 
-    /// grant friend status to DataPartition to access Iterator_
+    /// grant friend status to DataPartition to access Point_
     friend DataPartition;
 
 private:
@@ -122,8 +124,8 @@ private:
     /// owning DataPartition
     const DataPartition* Partition_;
 
-    /// iterator within vector<DataPoint>
-    DataPointVector::iterator Iterator_;
+    /// DataPoint currently pointed at
+    DataPoint Point_;
 
 };
 
@@ -161,15 +163,16 @@ protected:
 
     /// Constructor
     /// \param sm StatusManager to copy StatusManager structure from
-    /// \param begin vector<DataPoint>::iterator of start
-    /// \param end vector<DataPoint>::iterator of end
-    DataPartition(const StatusManager& sm, DataPointVector::iterator begin, DataPointVector::iterator end)
+    /// \param begin DataPoint of start
+    /// \param end DataPoint of end
+    DataPartition(const StatusManager& sm, const DataPoint& begin, const DataPoint& end)
         : StatusManager(sm), Begin_(*this, begin), End_(*this, end) {}
 
     /// constructor taking a DataAccessorSet
     /// \param sDA DataAccessorSet to initialize StatusManager from
-    DataPartition(const DataAccessorSet& sDA)
-        : StatusManager(sDA), Begin_(*this), End_(*this) {}
+    /// \param arena MemoryArena to carve status table from (nullptr for heap)
+    DataPartition(const DataAccessorSet& sDA, std::shared_ptr<MemoryArena> arena = nullptr)
+        : StatusManager(sDA, arena), Begin_(*this), End_(*this) {}
 
 public:
 
@@ -198,14 +201,14 @@ public:
 
     /// \return size
     virtual const size_t size() const
-    { return difference(end().Iterator_, begin().Iterator_); }
+    { return difference(rawIterator(end()), rawIterator(begin())); }
 
-    /// difference between two `DataPointVector::iterator`s to be used in
+    /// difference between two rows to be used in
     /// `operator-(const DataIterator&, const DataIterator&)`
     /// \param lhs left operand
     /// \param rhs right operand
     /// \attention Must be overloaded in derived classes
-    virtual const DataIterator::difference_type difference(const DataPointVector::iterator& lhs, const DataPointVector::iterator& rhs) const = 0;
+    virtual const DataIterator::difference_type difference(size_t lhs, size_t rhs) const = 0;
 
     /// grant friend status to DataIterator to call increment
     friend DataIterator;
@@ -219,34 +222,34 @@ protected:
     /// \attention Must be overloaded in derived classes
     virtual DataIterator& increment(DataIterator& it, DataIterator::difference_type n) const = 0;
 
-    /// \return vector<DataPoint> iterator inside DataIterator
+    /// \return row pointed to by DataIterator
     /// \param it DataIterator to access
-    DataPointVector::iterator& rawIterator(DataIterator& it) const
-    { return it.Iterator_; }
+    size_t& rawIterator(DataIterator& it) const
+    { return it.Point_.Row_; }
 
-    /// \return vector<DataPoint> iterator inside DataIterator
+    /// \return row pointed to by DataIterator
     /// \param it DataIterator to access
-    const DataPointVector::iterator& rawIterator(const DataIterator& it) const
-    { return it.Iterator_; }
+    const size_t& rawIterator(const DataIterator& it) const
+    { return it.Point_.Row_; }
 
-    /// \return DataIterator for vector<DataPoint> iterator
-    /// \param raw_it vector<DataPoint>::iterator to use
-    DataIterator dataIterator(DataPointVector::iterator it, const DataPartition* part) const
-    { return (part) ? DataIterator(*part, it) : DataIterator(*this, it); }
+    /// \return DataIterator for DataPoint
+    /// \param d DataPoint to point at
+    /// \param part DataPartition to own iterator
+    DataIterator dataIterator(const DataPoint& d, const DataPartition* part) const
+    { return (part) ? DataIterator(*part, d) : DataIterator(*this, d); }
 
     /// set begin
-    const DataIterator& setBegin(DataPointVector::iterator it)
-    { Begin_ = DataIterator(*this, it); return Begin_; }
+    const DataIterator& setBegin(const DataPoint& d)
+    { Begin_ = DataIterator(*this, d); return Begin_; }
 
     /// set end
-    const DataIterator& setEnd(DataPointVector::iterator it)
-    { End_ = DataIterator(*this, it); return End_; }
+    const DataIterator& setEnd(const DataPoint& d)
+    { End_ = DataIterator(*this, d); return End_; }
 
-    /// get non-const begin from DataSet
-    static DataPointVector::iterator begin(DataSet& ds);
-
-    /// get non-const end from DataSet
-    static DataPointVector::iterator end(DataSet& ds);
+    /// \return non-const DataPoint of row of DataSet
+    /// \param ds DataSet
+    /// \param r row
+    static DataPoint row(DataSet& ds, size_t r);
 
 private:
 
@@ -266,13 +269,13 @@ class DataPartitionWeave : public DataPartition
 {
 public:
 
-    /// Constructor
+    /// Constructor; end is moved up to the first point reached from begin
+    /// in whole steps of spacing, so that iteration from begin reaches it
     /// \param sm StatusManager to copy StatusManager structure from
-    /// \param begin vector<DataPoint>::iterator of start
-    /// \param end vector<DataPoint>::iterator of end
+    /// \param begin DataPoint of start
+    /// \param end DataPoint of end
     /// \param spacing Spacing between consecutively evaluated points
-    DataPartitionWeave(const StatusManager& sm, DataPointVector::iterator begin, DataPointVector::iterator end, unsigned spacing)
-        : DataPartition(sm, begin, end), Spacing_(spacing) {}
+    DataPartitionWeave(const StatusManager& sm, const DataPoint& begin, const DataPoint& end, unsigned spacing);
 
     /// \return DataParitionVector covering DataSet as a weave
     /// \param dataSet The dataSet
@@ -283,7 +286,7 @@ public:
     /// `operator-(const DataIterator&, const DataIterator&)`
     /// \param lhs left operand
     /// \param rhs right operand
-    virtual const DataIterator::difference_type difference(const DataPointVector::iterator& lhs, const DataPointVector::iterator& rhs) const override
+    virtual const DataIterator::difference_type difference(size_t lhs, size_t rhs) const override
     { return DataPartition::difference(lhs, rhs) / Spacing_; }
 
 protected:
@@ -291,8 +294,9 @@ protected:
     /// constructor taking a DataAccessorSet
     /// \param sDA DataAccessorSet to initialize StatusManager from
     /// \param spacing for weave
-    DataPartitionWeave(const DataAccessorSet& sDA, unsigned spacing)
-        : DataPartition(sDA), Spacing_(spacing) {}
+    /// \param arena MemoryArena to carve status table from (nullptr for heap)
+    DataPartitionWeave(const DataAccessorSet& sDA, unsigned spacing, std::shared_ptr<MemoryArena> arena = nullptr)
+        : DataPartition(sDA, arena), Spacing_(spacing) {}
 
     /// increment DataIterator
     /// \param it DataIterator to iterate
@@ -324,15 +328,16 @@ protected:
 
     /// Constructor
     /// \param sm StatusManager to copy StatusManager structure from
-    /// \param begin vector<DataPoint>::iterator of start
-    /// \param end vector<DataPoint>::iterator of end
-    DataPartitionBlock(const StatusManager& sm, DataPointVector::iterator begin, DataPointVector::iterator end)
+    /// \param begin DataPoint of start
+    /// \param end DataPoint of end
+    DataPartitionBlock(const StatusManager& sm, const DataPoint& begin, const DataPoint& end)
         : DataPartitionWeave(sm, begin, end, 1) {}
 
     /// constructor taking a DataAccessorSet
     /// \param sDA DataAccessorSet to initialize StatusManager from
-    DataPartitionBlock(const DataAccessorSet& sDA)
-        : DataPartitionWeave(sDA, 1) {}
+    /// \param arena MemoryArena to carve status table from (nullptr for heap)
+    DataPartitionBlock(const DataAccessorSet& sDA, std::shared_ptr<MemoryArena> arena = nullptr)
+        : DataPartitionWeave(sDA, 1, arena) {}
 
 };
 
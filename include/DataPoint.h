@@ -22,58 +22,85 @@
 #define yap_DataPoint_h
 
 #include "fwd/DataAccessor.h"
+#include "fwd/StoragePrecision.h"
 
+#include "DataColumns.h"
+
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace yap {
 
 /// \class DataPoint
-/// \brief Class for holding data and cached values per data point for fast calculation
+/// \brief Handle to one row of cached values inside a #DataColumns object
 /// \author Johannes Rauch, Daniel Greenwald
 /// \defgroup Data Data-related classes
+///
+/// A DataPoint does not hold its own values: it refers to a row of the
+/// columnar storage of a #DataSet. Copies of a DataPoint refer to the
+/// same row. A DataPoint constructed from a DataAccessorSet owns a
+/// private single-row storage shared among its copies.
 class DataPoint
 {
 public:
 
-    /// Constructor
-    /// \param dataSet DataSet this DataPoint belongs to
-    DataPoint(const DataAccessorSet& dataAccessorSet);
+    /// Constructor, creating a DataPoint with its own storage
+    /// \param dataAccessorSet DataAccessorSet to take structure from
+    /// \param precision maximum StoragePrecision of values
+    DataPoint(const DataAccessorSet& dataAccessorSet, StoragePrecision precision);
 
     /// \return number of data accessor rows
     size_t nDataAccessors() const
-    { return Data_.size(); }
+    { return Columns_->nDataAccessors(); }
 
     /// \return size of data point
     unsigned bytes() const;
 
+    /// \return index of row within its storage
+    size_t row() const
+    { return Row_; }
+
     /// check that two DataPoint's have same internal structure
-    friend bool equalStructure(const DataPoint& A, const DataPoint& B);
+    friend bool equalStructure(const DataPoint& A, const DataPoint& B)
+    { return equalStructure(*A.Columns_, *B.Columns_); }
 
     /// check that two DataPoint's are equal
     friend bool operator==(const DataPoint& lhs, const DataPoint& rhs)
-    { return lhs.Data_ == rhs.Data_; }
+    { return equalRows(*lhs.Columns_, lhs.Row_, *rhs.Columns_, rhs.Row_); }
 
-    /// grant friend status to CachedValue to access Data_
+    /// grant friend status to CachedValue to access Columns_ and Row_
     friend class CachedValue;
 
-/// precompiler flag for data storage type
-#ifdef YAP_DATA_POINT_FLOAT
-    using type = float;
-# else
-    using type = double;
-#endif
+    /// grant friend status to DataIterator to construct DataPoint's
+    friend class DataIterator;
+
+    /// grant friend status to DataPartition to access Row_
+    friend class DataPartition;
+
+    /// grant friend status to DataSet to construct DataPoint's
+    friend class DataSet;
 
 private:
 
-    /// Data storage for all DataAccessors
-    /// first index is for the DataAccessor
-    /// second index is for the symmeterization state (as known by the DataAccessor) internal to the DataAccessor
-    /// i = symIndex * size + position
-    std::vector<std::vector<type> > Data_;
+    /// default constructor, refers to nothing
+    DataPoint() : Columns_(nullptr), Row_(0) {}
 
-};
+    /// constructor referring to a row of existing storage
+    /// \param c DataColumns to refer to
+    /// \param r row to refer to
+    DataPoint(DataColumns& c, size_t r) : Columns_(&c), Row_(r) {}
+
+    /// Storage owned by DataPoint's not belonging to a DataSet
+    std::shared_ptr<DataColumns> Storage_;
+
+    /// Storage referred to
+    DataColumns* Columns_;
 
+    /// row inside Columns_
+    size_t Row_;
+
+};
 
 }
 
@@ -23,25 +23,68 @@
 
 #include "fwd/DataPoint.h"
 #include "fwd/FourVector.h"
+#include "fwd/MemoryArena.h"
 #include "fwd/Model.h"
+#include "fwd/StaticDataCache.h"
 #include "fwd/StatusManager.h"
 
+#include "DataColumns.h"
 #include "DataPartition.h"
+#include "StoragePrecision.h"
 
+#include <memory>
 #include <vector>
 
 namespace yap {
 
 /// \class DataSet
-/// \brief Class holding a set of DataPoint objects.
+/// \brief Class holding a set of data points in columnar storage.
 /// \author Johannes Rauch, Daniel Greenwald
 /// \ingroup Data
+///
+/// The cached values of all data points are stored in a #DataColumns
+/// object; #DataPoint's obtained from a DataSet are handles to its rows.
+///
+/// The precision of a DataSet caps the StoragePrecision of all cached
+/// values in it: a single-precision DataSet stores everything as float.
+/// A fixed-point DataSet stores values with a known bound (e.g. helicity
+/// spin amplitudes) as 16-bit fixed point, and everything else as float;
+/// the resulting error is reported by #quantizationError.
+///
+/// If given a #MemoryArena, the columns and the status tables of the
+/// DataSet and of all DataPartition's created from it are carved from
+/// the arena. Reserve the full number of data points up front to carve
+/// the columns only once.
+///
+/// The values of StaticDataAccessor's can be stored to a file with
+/// #write_static_data_cache and later mapped into a DataSet with #map,
+/// without calculating them again.
+///
+/// The begin and end iterators are updated whenever the number of data
+/// points changes, so that #begin and #end write nothing and may be
+/// called concurrently, e.g. by DataAccessor's calculated in parallel.
 class DataSet : public DataPartitionBlock
 {
 public:
 
     /// Constructor
-    DataSet(const Model& m);
+    /// \param m Model to take structure from
+    /// \param precision maximum StoragePrecision of cached values
+    /// \param arena MemoryArena to carve storage from (nullptr for heap)
+    DataSet(const Model& m, StoragePrecision precision = StoragePrecision::double_precision,
+            std::shared_ptr<MemoryArena> arena = nullptr);
+
+    /// copy constructor
+    DataSet(const DataSet& other);
+
+    /// move constructor
+    DataSet(DataSet&& other);
+
+    /// copy assignment operator
+    DataSet& operator=(const DataSet& other);
+
+    /// move assignment operator
+    DataSet& operator=(DataSet&& other);
 
     /// Check if data point is consisent with data set
     bool consistent(const DataPoint& d) const;
@@ -54,7 +97,8 @@ public:
     /// needed by std::back_inserter and std::inserter
     using value_type = std::vector<FourVector<double> >;
 
-    /// creates a new #DataPoint and calls #Model::setFinalStateMomenta on it
+    /// creates a new #DataPoint (with its own storage, not added to
+    /// the DataSet) and calls #Model::setFinalStateMomenta on it
     /// \param P the momenta to be set
     /// \param sm StatusManager to use when calling #Model::setFinalStateMomenta
     /// \return the created #DataPoint
@@ -66,53 +110,54 @@ public:
     const DataPoint createDataPoint(const std::vector<FourVector<double> >& P)
     { return createDataPoint(P, *this); }
 
-    /// creates a DataPoint from a vector of FourVector's using #createDataPoint
-    /// and pushes it back in the vector data points
-    /// \param P vector of FourVector's to create DataPoint from
-    void push_back(const std::vector<FourVector<double> >& P)
-    { DataPoints_.push_back(createDataPoint(P)); }
+    /// adds a data point to the end of the data set
+    /// and calls #Model::setFinalStateMomenta on it
+    /// \param P vector of FourVector's to set
+    void push_back(const std::vector<FourVector<double> >& P);
 
-    /// checks consistency of DataPoint, and pushes it back in the vector of data points
+    /// checks consistency of DataPoint, and copies its values into a
+    /// new data point at the end of the data set
     /// \param d DataPoint to copy into DataSet
     void push_back(const DataPoint& d);
 
-    /// checks consistency of DataPoint, and pushes it back in the vector of data points
-    /// \param d DataPoint to move into DataSet
-    void push_back(DataPoint&& d);
-
-    /// creates a DataPoint from a vector of FourVector's using #createDataPoint
-    /// and inserts it into the vector of DataPoint's at a specified position
+    /// inserts a data point at a specified position
+    /// and calls #Model::setFinalStateMomenta on it
     /// \param pos DataIterator of position in DataSet to insert into
-    /// \param P vector of FourVector to create DataPoint from
-    DataIterator insert(DataIterator pos, const std::vector<FourVector<double> >& P)
-    { return dataIterator(DataPoints_.insert(rawIterator(pos), createDataPoint(P)), pos.partition()); }
+    /// \param P vector of FourVector to set
+    DataIterator insert(const DataIterator& pos, const std::vector<FourVector<double> >& P);
 
-    /// checks consistency of DataPoint and inserts it into vector of
-    /// data points at specifief position
+    /// checks consistency of DataPoint and copies its values into a
+    /// new data point at specified position
     /// \param pos DataIterator of position in DataSet to insert into
     /// \param d DataPoint to copy into DataSet
     DataIterator insert(const DataIterator& pos, const DataPoint& d);
 
-    /// checks consistency of DataPoint and inserts it into vector of
-    /// data points at specifief position
-    /// \param pos DataIterator of position in DataSet to insert into
-    /// \param d DataPoint to move into DataSet
-    DataIterator insert(const DataIterator& pos, DataPoint&& d);
+    /// replace the data points by those of a StaticDataCache, mapping its
+    /// columns without copying them. Values of StaticDataAccessor's are marked
+    /// as calculated; values of all other DataAccessor's are zeroed.
+    /// \param cache StaticDataCache written from a DataSet of an equivalent Model and of same precision
+    void map(std::shared_ptr<StaticDataCache> cache);
+
+    /// replace the data points by data points [first, last) of a StaticDataCache,
+    /// mapping its columns without copying them (see #map(std::shared_ptr<StaticDataCache>))
+    /// \param cache StaticDataCache written from a DataSet of an equivalent Model and of same precision
+    /// \param first index of first data point in cache to map
+    /// \param last index beyond last data point in cache to map
+    void map(std::shared_ptr<StaticDataCache> cache, size_t first, size_t last);
 
     /// clear the data set
     void clear()
-    { DataPoints_.clear(); }
+    { Columns_.clear(); setIterators(); }
 
     /// removes last element added to data set
     /// \warning DataIterator's and DataPartition's referring to this DataSet will most likely be invalidated
     void pop_back()
-    { DataPoints_.pop_back(); }
+    { Columns_.resize(Columns_.size() - 1); setIterators(); }
 
     /// remove specified element from data set.
     /// \warning DataIterator's and DataPartition's referring to this DataSet will most likely be invalidated
     /// \param pos iterator to element to remove
-    DataIterator erase(const DataIterator& pos)
-    { return dataIterator(DataPoints_.erase(rawIterator(pos)), pos.partition()); }
+    DataIterator erase(const DataIterator& pos);
 
     /// remove specified elements from data set
     /// \warning DataIterator's and DataPartition's referring to this DataSet will most likely be invalidated
@@ -120,73 +165,88 @@ public:
     /// \param last iterator beyond last element to remove
     DataIterator erase(const DataIterator& first, const DataIterator& last);
 
-    /// \return iterator to front of set
-    const DataIterator& begin() const override
-    { return const_cast<DataSet*>(this)->setBegin(const_cast<DataPointVector*>(&DataPoints_)->begin()); }
-
-    /// \return iterator to end of set
-    const DataIterator& end() const override
-    { return const_cast<DataSet*>(this)->setEnd(const_cast<DataPointVector*>(&DataPoints_)->end()); }
-
     /// access by index
-    DataPoint& operator[](size_t i)
-    { return DataPoints_[i]; }
+    DataPoint operator[](size_t i)
+    { return DataPoint(Columns_, i); }
 
     /// access by index (with check)
-    DataPoint& at(size_t i)
-    { return DataPoints_.at(i); }
+    DataPoint at(size_t i);
 
     /// access front
-    const DataPoint& front() const
-    { return DataPoints_.front(); }
+    const DataPoint front() const
+    { return DataPoint(const_cast<DataColumns&>(Columns_), 0); }
 
     /// access back
-    const DataPoint& back() const
-    { return DataPoints_.back(); }
+    const DataPoint back() const
+    { return DataPoint(const_cast<DataColumns&>(Columns_), Columns_.size() - 1); }
 
     /// \return size of data set in bytes
     const unsigned bytes() const;
 
     /// \return number of data points
     const size_t size() const override
-    { return DataPoints_.size(); }
+    { return Columns_.size(); }
 
     /// \return maximum possible number data points that can be stored
     const size_t max_size() const
-    { return DataPoints_.max_size(); }
+    { return Columns_.max_size(); }
 
     /// \return number of data points that can be held in currently allocated storage
     const size_t capacity() const
-    { return DataPoints_.capacity(); }
+    { return Columns_.capacity(); }
 
-    /// \return whether DataPoints_ is empty
+    /// \return whether data set is empty
     const bool empty() const
-    { return DataPoints_.empty(); }
+    { return Columns_.size() == 0; }
 
     /// reserve storage space
     void reserve(size_t n)
-    { DataPoints_.reserve(n); }
+    { Columns_.reserve(n); }
 
-    /// call shrink to fit on DataPoints_
+    /// call shrink to fit on storage
     void shrink_to_fit()
-    { DataPoints_.shrink_to_fit(); }
+    { Columns_.shrink_to_fit(); }
 
     /// \return raw pointer to associated model
     const Model* model() const
     { return Model_; }
 
-    /// grant friend status to DataPartition to access non-const dataPoints()
+    /// \return MemoryArena storage is carved from (nullptr if heap)
+    std::shared_ptr<MemoryArena> arena() const
+    { return Columns_.arena(); }
+
+    /// \return maximum StoragePrecision of cached values
+    const StoragePrecision precision() const
+    { return Columns_.precision(); }
+
+    /// \return largest absolute error of any cached value due to being
+    /// stored as fixed point (0 if none are)
+    const double quantizationError() const;
+
+    /// \return columnar storage of data points
+    const DataColumns& columns() const
+    { return Columns_; }
+
+    /// \return whether values are mapped from a StaticDataCache
+    bool mapped() const
+    { return Columns_.mapped(); }
+
+    /// grant friend status to DataPartition to access non-const columns()
     friend DataPartition;
 
 protected:
 
-    /// non-const access to DataPoints_
-    DataPointVector& dataPoints()
-    { return DataPoints_; }
+    /// non-const access to Columns_
+    DataColumns& columns()
+    { return Columns_; }
 
 private:
-    /// vector of data points contained in set
-    DataPointVector DataPoints_;
+
+    /// point begin and end iterators at first row and beyond last row of Columns_
+    void setIterators();
+
+    /// columnar storage of the data points contained in set
+    DataColumns Columns_;
 
     /// Associated model
     const Model* Model_;
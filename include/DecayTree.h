@@ -72,6 +72,10 @@ public:
     const SpinProjectionVector& finalTwoM() const
     { return FinalTwoM_; }
 
+    /// \return index of spin amplitude for InitialTwoM_ and FinalTwoM_
+    const unsigned amplitudeIndex() const
+    { return AmplitudeIndex_; }
+
     /// \return DaughterDecayTrees_
     const DaughterDecayTreeMap daughterDecayTrees() const
     { return DaughterDecayTrees_; }
@@ -126,6 +130,10 @@ private:
     /// daughter spin projections
     SpinProjectionVector FinalTwoM_;
 
+    /// index of spin amplitude in FreeAmplitude's SpinAmplitude,
+    /// resolved from spin projections at construction
+    unsigned AmplitudeIndex_;
+
     /// vector of AmplitudeComponent's
     std::vector<const AmplitudeComponent*> AmplitudeComponents_;
 
@@ -27,9 +27,11 @@
 
 #include "fwd/DecayTree.h"
 #include "fwd/Model.h"
+#include "fwd/RecalculableDataAccessor.h"
 
 #include <array>
 #include <complex>
+#include <vector>
 
 namespace yap {
 
@@ -70,6 +72,11 @@ public:
     /// \return Model this integral calculates with (via DecayTrees)
     const Model* model() const;
 
+    /// \return whether parameters of the data-dependent amplitudes of
+    /// the DecayTrees have changed since integral was last reset
+    const bool changed() const
+    { return generation() != Generation_; }
+
     /// \return Diagonals_ (const)
     const RealIntegralElementVector& diagonals() const
     { return Diagonals_; }
@@ -94,13 +101,24 @@ public:
 
 protected:
 
+    /// zero all components and record current generation of parameters
     DecayTreeVectorIntegral& reset();
 
 private:
 
+    /// \return sum of generations of RecalculableDataAccessors_,
+    /// which changes whenever any of their parameters changes
+    unsigned generation() const;
+
     /// DecayTrees to integrate
     const DecayTreeVector DecayTrees_;
 
+    /// RecalculableDataAccessor's among amplitude components of DecayTrees_ (and their daughters)
+    std::vector<const RecalculableDataAccessor*> RecalculableDataAccessors_;
+
+    /// generation of parameters integral was last reset with
+    unsigned Generation_;
+
     /// diagonal element integrals:
     /// stores norm(dataDependentAmplitude(...)),
     /// for each DecayTree in DecayTrees_
@@ -0,0 +1,252 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/// \file
+
+#ifndef yap_EnsembleSampler_h
+#define yap_EnsembleSampler_h
+
+#include "fwd/EnsembleSampler.h"
+
+#include "fwd/DataPartition.h"
+#include "fwd/FreeAmplitude.h"
+#include "fwd/Model.h"
+#include "fwd/ModelIntegral.h"
+#include "fwd/Parameter.h"
+
+#include "AmplitudeMatrix.h"
+
+#include <complex>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace yap {
+
+/// \class EnsembleSampler
+/// \brief Affine-invariant ensemble Markov chain Monte Carlo sampler of
+/// the likelihood of a Model in its amplitude parameters
+/// \author Daniel Greenwald
+///
+/// Samples the normalized likelihood (with flat priors) of a Model in
+/// the real and imaginary parts of its non-fixed FreeAmplitude's and
+/// its non-fixed ModelComponent admixtures (bounded below by zero),
+/// with the stretch move of Goodman and Weare: the walkers are split
+/// in two halves, and each walker of one half proposes a point on the
+/// line through it and a random walker of the other half.
+///
+/// Shape parameters are held at their values: the data-dependent
+/// amplitudes are then the same for all walkers, and are stored once
+/// per DataPartition in an AmplitudeMatrix. All proposals of a
+/// half-step are evaluated in one pass over the data, by worker
+/// threads (one per DataPartition) that persist for the lifetime of
+/// the sampler. The walkers' parameters are not set into the Model.
+///
+/// Chains are written to a binary file holding a header (8-byte magic
+/// "YAPMCMC", uint32 version, uint32 number of parameters, uint64
+/// number of walkers), followed, for each step and walker, by the
+/// walker's parameters and log-likelihood as doubles.
+class EnsembleSampler
+{
+public:
+
+    /// Constructor
+    /// \param M Model to sample
+    /// \param fit_partitions DataPartitionVector of data to calculate likelihood over
+    /// \param MI ModelIntegral of M, up to date with its parameters, to normalize with
+    /// \param n_walkers number of walkers (even; should be at least twice the number of parameters)
+    /// \param seed seed of random number generator
+    EnsembleSampler(const Model& M, DataPartitionVector fit_partitions, const ModelIntegral& MI,
+                    unsigned n_walkers, unsigned seed = 0);
+
+    /// Destructor, stops worker threads
+    ~EnsembleSampler();
+
+    /// copy constructor (deleted)
+    EnsembleSampler(const EnsembleSampler&) = delete;
+
+    /// copy assignment operator (deleted)
+    EnsembleSampler& operator=(const EnsembleSampler&) = delete;
+
+    /// \return non-fixed free amplitudes, whose real and imaginary
+    /// parts are the first parameters
+    const FreeAmplitudeVector& freeAmplitudes() const
+    { return FreeAmplitudes_; }
+
+    /// \return non-fixed admixtures, which are the last parameters
+    const NonnegativeRealParameterVector& admixtures() const
+    { return Admixtures_; }
+
+    /// \return number of parameters
+    const size_t nParameters() const
+    { return 2 * FreeAmplitudes_.size() + Admixtures_.size(); }
+
+    /// \return current values of parameters in Model
+    std::vector<double> parameters() const;
+
+    /// \return positions of walkers
+    const std::vector<std::vector<double> >& walkers() const
+    { return Walkers_; }
+
+    /// \return log-likelihoods of walkers
+    const std::vector<double>& logLikelihoods() const
+    { return LogLikelihoods_; }
+
+    /// \return fraction of proposals accepted since last initialization
+    const double acceptanceRate() const
+    { return Proposals_ == 0 ? 0. : static_cast<double>(Accepted_) / Proposals_; }
+
+    /// set scale of stretch move (default 2)
+    void setStretchScale(double a);
+
+    /// scatter walkers normally around current values of parameters in Model,
+    /// taking up changes to Model and ModelIntegral since construction
+    /// \param spread width of scatter, relative to magnitude of each parameter (or one, if larger)
+    void initialize(double spread = 1.e-2);
+
+    /// advance all walkers, initializing them if not yet done,
+    /// and write their positions to chain file, if open;
+    /// takes up changes to values of Model's parameters and to ModelIntegral,
+    /// but not to which of its free amplitudes and admixtures are fixed
+    /// \param n_steps number of steps
+    void run(unsigned n_steps);
+
+    /// open chain file, overwriting it, and write its header
+    /// \param filename name of file
+    void openChainFile(const std::string& filename);
+
+    /// close chain file
+    void closeChainFile();
+
+    /// \return log-likelihoods of points in parameter space,
+    /// calculated in one pass over the data; -infinity for points out of bounds
+    /// \param X points in parameter space
+    std::vector<double> logLikelihood(const std::vector<std::vector<double> >& X);
+
+private:
+
+    /// update products of fixed free amplitudes, amplitude matrices,
+    /// and integral components from Model and ModelIntegral;
+    /// throws if the set of non-fixed free amplitudes or admixtures has changed since construction
+    void prepare();
+
+    /// perform task for each DataPartition in worker threads, and wait for all to finish
+    void parallel(const std::function<void(size_t)>& task);
+
+    /// stop and join worker threads
+    void stop();
+
+    /// loop of worker thread
+    /// \param p index of DataPartition of worker
+    void work(size_t p);
+
+    /// Model to sample
+    const Model* Model_;
+
+    /// data to calculate likelihood over
+    DataPartitionVector FitPartitions_;
+
+    /// integral of Model
+    const ModelIntegral* Integral_;
+
+    /// data-dependent amplitudes, by DataPartition
+    std::vector<AmplitudeMatrix> Matrices_;
+
+    /// number of data points
+    size_t NDataPoints_;
+
+    /// non-fixed free amplitudes
+    FreeAmplitudeVector FreeAmplitudes_;
+
+    /// non-fixed admixtures
+    NonnegativeRealParameterVector Admixtures_;
+
+    /// product of fixed free amplitudes, by ModelComponent and DecayTree
+    std::vector<std::vector<std::complex<double> > > FixedFactors_;
+
+    /// indices into FreeAmplitudes_ of non-fixed free amplitudes
+    /// (including repeats), by ModelComponent and DecayTree
+    std::vector<std::vector<std::vector<size_t> > > FreeFactors_;
+
+    /// index into Admixtures_ of admixture of each ModelComponent (-1 if fixed)
+    std::vector<int> AdmixtureIndices_;
+
+    /// integral components conj(A_i) * A_j, by ModelComponent
+    std::vector<std::vector<std::vector<std::complex<double> > > > IntegralComponents_;
+
+    /// positions of walkers
+    std::vector<std::vector<double> > Walkers_;
+
+    /// log-likelihoods of walkers
+    std::vector<double> LogLikelihoods_;
+
+    /// number of walkers
+    unsigned NWalkers_;
+
+    /// scale of stretch move
+    double StretchScale_;
+
+    /// random number generator
+    std::mt19937 Generator_;
+
+    /// number of proposals made since initialization
+    unsigned long Proposals_;
+
+    /// number of proposals accepted since initialization
+    unsigned long Accepted_;
+
+    /// chain file
+    std::ofstream ChainFile_;
+
+    /// worker threads, one per DataPartition
+    std::vector<std::thread> Workers_;
+
+    /// mutex guarding task state
+    std::mutex Mutex_;
+
+    /// signals workers of new task
+    std::condition_variable Start_;
+
+    /// signals caller of finished task
+    std::condition_variable Done_;
+
+    /// current task
+    const std::function<void(size_t)>* Task_;
+
+    /// number of tasks given to workers so far
+    unsigned TaskGeneration_;
+
+    /// number of workers still performing current task
+    unsigned Pending_;
+
+    /// first exception thrown by a worker in current task
+    std::exception_ptr Error_;
+
+    /// whether workers should stop
+    bool Stop_;
+
+};
+
+}
+
+#endif
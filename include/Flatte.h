@@ -24,18 +24,17 @@
 #include "fwd/Flatte.h"
 
 #include "fwd/DataPartition.h"
-#include "fwd/DataPoint.h"
 #include "fwd/FinalStateParticle.h"
 #include "fwd/Parameter.h"
 #include "fwd/ParticleCombination.h"
 #include "fwd/ParticleTable.h"
-#include "fwd/StatusManager.h"
 
 #include "MassShapeWithNominalMass.h"
 
 #include <array>
 #include <complex>
 #include <memory>
+#include <vector>
 
 namespace yap {
 
@@ -45,7 +44,9 @@ namespace yap {
 /// \ingroup MassShapes
 ///
 /// Amplitude is 1 / (mass^2 - s - i * sum_channels(coupling * phase-space factor)\n\n
-/// phase space factor := 2 * breakup-momentum / sqrt(s); may be complex
+/// phase space factor := 2 * breakup-momentum / sqrt(s); may be complex\n\n
+/// Breakup momenta are calculated channel by channel over a batch of data
+/// points, taking real or imaginary square roots without branching.
 class Flatte : public MassShapeWithNominalMass
 {
 public:
@@ -69,37 +70,25 @@ public:
     /// Cheks that decay is to a channel of the Flatte
     virtual void checkDecayChannel(const DecayChannel& c) const override;
 
-    /// update the calculationStatus for a DataPartition
-    virtual void updateCalculationStatus(StatusManager& D) const override;
-    
-    /// \return value for DataPoint and ParticleCombination
-    /// \param d DataPoint
-    /// \param pc shared_ptr to ParticleCombination
-    virtual const std::complex<double> value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const override;
-
-    using MassShapeWithNominalMass::calculate;
-    
-    /// Calculate dynamic amplitude T for and store in each DataPoint in DataPartition
-    /// \param D DataPartition to calculate on
-    /// \param pc ParticleCombination to calculate for
-    /// \param si SymmetrizationIndec to calculate for
-    virtual void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const override;
-
-
 protected:
 
-    /// access cached dynamic amplitude
-    const std::shared_ptr<ComplexCachedValue> T() const
-    { return T_; }
+    /// Calculate dynamic amplitudes for a batch of data points
+    /// \param B MassShapeBatch holding masses, whose amplitudes T to fill
+    /// \param first iterator to first data point of batch
+    /// \param pc ParticleCombination to calculate for
+    virtual void calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const override;
 
 private:
 
-    /// cached dynamic amplitude
-    std::shared_ptr<ComplexCachedValue> T_;
-
     /// Flatte channels for width calculation
     std::vector<FlatteChannel> FlatteChannels_;
 
+    /// squared sums of masses of Flatte channels' particles, by channel
+    std::vector<double> ThresholdM2_;
+
+    /// squared differences of masses of Flatte channels' particles, by channel
+    std::vector<double> PseudothresholdM2_;
+
 };
 
 /// \struct FlatteChannel
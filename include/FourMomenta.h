@@ -22,6 +22,7 @@
 #define yap_FourMomenta_
 
 #include "fwd/CachedValue.h"
+#include "fwd/DataPartition.h"
 #include "fwd/DataPoint.h"
 #include "fwd/FinalStateParticle.h"
 #include "fwd/FourVector.h"
@@ -77,6 +78,13 @@ public:
     /// \param pc ParticleCombination to return mass of
     double m(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const;
 
+    /// Gather invariant masses of consecutive data points into an array
+    /// \param first iterator to first DataPoint to get data from
+    /// \param n number of data points
+    /// \param pc ParticleCombination to return masses of
+    /// \param m array of (at least) n masses to fill
+    void m(DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc, double* m) const;
+
     /// \return vector of final-state four-momenta (const)
     /// \param d DataPoint to get data from
     const std::vector<FourVector<double> > finalStateMomenta(const DataPoint& d) const;
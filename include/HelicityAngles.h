@@ -22,6 +22,7 @@
 #define yap_HelicityAngles_h
 
 #include "fwd/CachedValue.h"
+#include "fwd/DataPoint.h"
 #include "fwd/Model.h"
 #include "fwd/ParticleCombination.h"
 #include "fwd/StatusManager.h"
@@ -31,8 +32,8 @@
 #include "StaticDataAccessor.h"
 #include "ThreeVector.h"
 
+#include <limits>
 #include <memory>
-#include <mutex>
 
 namespace yap {
 
@@ -57,37 +58,44 @@ namespace yap {
 ///   - \f$ \hat{y} \equiv \hat{y}_0 \f$
 ///   - \f$ \hat{x} \equiv \hat{x}_0 \f$
 /// with the 0th coordinate system given by the user for the inital state
-class HelicityAngles
+///
+/// Angles are calculated once per data point, when final-state momenta
+/// are set, and stored for each particle combination a
+/// HelicitySpinAmplitude is calculated for.
+class HelicityAngles : public StaticDataAccessor
 {
 public:
 
     /// Constructor
     /// \param m owning Model
-    HelicityAngles(Model& m) : Model_(&m) {}
-
-    /// get helicity angles
-    const spherical_angles<double>& operator()(const DataPoint& d, const StatusManager& sm, const std::shared_ptr<const ParticleCombination>& pc) const;
+    HelicityAngles(Model& m);
 
-    /// Clear the cache for StatusManager
-    void clearCache(const StatusManager& sm) const;
+    /// Calculate helicity angles and store them into DataPoint
+    /// \param d DataPoint to fill
+    /// \param sm StatusManager to update
+    virtual void calculate(DataPoint& d, StatusManager& sm) const override;
 
-private:
+    /// get helicity angles; calculated if not stored for pc
+    /// \param d DataPoint to get data from
+    /// \param pc ParticleCombination to return helicity angles of
+    const spherical_angles<double> operator()(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const;
 
-    /// Add cache for StatusManager (thread safe)
-    void addToCache(const StatusManager& sm) const;
+    /// grant friend status to HelicitySpinAmplitude to call addParticleCombination
+    friend class HelicitySpinAmplitude;
 
-    /// recursive helicity-angle calculator that travels down decay trees for all channels
-    void calculateAngles(const DataPoint& d, const StatusManager& sm,
-                         const std::shared_ptr<const ParticleCombination>& pc,
-                         const CoordinateSystem<double, 3>& C, const FourMatrix<double>& boosts) const;
+private:
 
-    Model* Model_;
+    /// calculate helicity angles of a particle combination by
+    /// boosting down through the decay tree from its origin
+    /// \param d DataPoint to get four-momenta from
+    /// \param pc ParticleCombination to calculate helicity angles of
+    spherical_angles<double> calculateAngles(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const;
 
-    using angles_cache = std::map<const std::shared_ptr<const ParticleCombination>, spherical_angles<double>>;
-    mutable std::map<const StatusManager*, angles_cache> CachedAngles_;
-    mutable std::map<const StatusManager*, const DataPoint*> CachedForDataPoint_;
+    /// azimuthal helicity angle
+    std::shared_ptr<RealCachedValue> Phi_;
 
-    mutable std::mutex CacheMutex_;
+    /// polar helicity angle
+    std::shared_ptr<RealCachedValue> Theta_;
 
 };
 
@@ -32,6 +32,7 @@
 #include <complex>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace yap {
 
@@ -53,20 +54,26 @@ protected:
 
 public:
 
+    using SpinAmplitude::amplitude;
+
     /// \return precalculated complex amplitude
     /// \param d DataPoint to retrieve value from
     /// \param pc ParticleCombination to retrieve value for
-    /// \param two_M 2 * spin projection of parent
-    /// \param two_m SpinProjectionVector of daughters
+    /// \param i index of amplitude
     virtual const std::complex<double> amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
-                                         int two_M, const SpinProjectionVector& two_m) const override
-    { return (initialTwoJ() == 0) ? Coefficients_.at(two_m) : SpinAmplitude::amplitude(d, pc, two_M, two_m); }
+                                                 unsigned i) const override
+    { return (initialTwoJ() == 0) ? AmplitudeCoefficients_[i] : SpinAmplitude::amplitude(d, pc, i); }
+
+    /// \return AmplitudeFactor, constant if initialTwoJ() == 0
+    /// \param pc ParticleCombination to read value for
+    /// \param i index of amplitude
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const override;
 
-    /// Overrides SpinAmplitude::calculate to do nothing if initialTwoJ() == 0
+    /// Overrides SpinAmplitude::calculate to do nothing if initialTwoJ() == 0,
+    /// and otherwise to calculate the full d-matrix once per particle combination
     /// \param d DataPoint to calculate into
     /// \param sm StatusManager to update
-    virtual void calculate(DataPoint& d, StatusManager& sm) const override
-    { if (initialTwoJ() != 0) SpinAmplitude::calculate(d, sm); }
+    virtual void calculate(DataPoint& d, StatusManager& sm) const override;
 
     /// Calculate spin amplitude for given ParticleCombination and spin projections
     /// \param two_M 2 * spin projection of parent
@@ -89,12 +96,21 @@ public:
     /// grant HelicityFormalism friend status to call constructor
     friend class HelicityFormalism;
 
+protected:
+
+    /// register with Model, and register particle combinations
+    /// with Model's HelicityAngles, if angles are needed
+    virtual void registerWithModel() override;
+
 private:
 
     /// map from (m1,m2) -> L-S * S-S coupling coefficients
     /// value is sqrt((2L+1)/4pi) * (L 0 S m1-m2 | J m1-m2) * (j1 m1 j2 m2 | S m1-m2);
     std::map<SpinProjectionVector, double> Coefficients_;
 
+    /// coupling coefficients, by amplitude index
+    std::vector<double> AmplitudeCoefficients_;
+
 };
 
 /// \class HelicityFormalism
@@ -29,6 +29,8 @@
 #include "fwd/FourVector.h"
 #include "fwd/ModelIntegral.h"
 
+#include "StoragePrecision.h"
+
 #include <functional>
 
 namespace yap {
@@ -62,7 +64,9 @@ public:
     /// \param N number of points to generate
     /// \param n batch size of points to generate
     /// \param t number of threads to use while integrating
-    static void calculate(ModelIntegral& I, Generator g, unsigned N, unsigned n, unsigned t = 1);
+    /// \param precision maximum StoragePrecision of cached values of generated points
+    static void calculate(ModelIntegral& I, Generator g, unsigned N, unsigned n, unsigned t = 1,
+                          StoragePrecision precision = StoragePrecision::double_precision);
 
     /// calculate amplitudes
     static void calculate(std::vector<std::complex<double> >& A, const DecayTreeVectorIntegral& I, const DataPoint& d);
@@ -76,7 +80,8 @@ public:
     /// perform calculation for one data partition
     static unsigned calculate_partition(std::vector<DecayTreeVectorIntegral*>& J, DataPartition& D);
 
-    static unsigned calculate_subset(std::vector<DecayTreeVectorIntegral*>& J, Generator g, unsigned N, unsigned n);
+    static unsigned calculate_subset(std::vector<DecayTreeVectorIntegral*>& J, Generator g, unsigned N, unsigned n,
+                                     StoragePrecision precision);
 
 };
 
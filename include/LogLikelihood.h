@@ -0,0 +1,106 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/// \file
+
+#ifndef yap_LogLikelihood_h
+#define yap_LogLikelihood_h
+
+#include "fwd/LogLikelihood.h"
+
+#include "fwd/DataPartition.h"
+#include "fwd/FreeAmplitude.h"
+#include "fwd/Model.h"
+#include "fwd/ModelIntegral.h"
+#include "fwd/Parameter.h"
+
+#include <complex>
+#include <vector>
+
+namespace yap {
+
+/// \struct LogLikelihood
+/// \brief Value, gradient, and Hessian of the log-likelihood of a Model
+/// \author Daniel Greenwald
+///
+/// The log-likelihood of N data points is
+/// sum_d log(I(d)) - N * log(integral of I), with I the intensity of
+/// the Model. Its gradient is given with respect to the real and
+/// imaginary parts of each non-fixed FreeAmplitude and with respect to
+/// each non-fixed ModelComponent admixture. Its Hessian with respect
+/// to the free amplitudes is given by #log_likelihood_hessian, the
+/// negative of whose inverse at the maximum of the likelihood
+/// estimates the covariance of the free amplitudes.
+struct LogLikelihood
+{
+    /// value of log-likelihood
+    double Value;
+
+    /// non-fixed free amplitudes, in order of first appearance in
+    /// the Model's components' DecayTree's
+    FreeAmplitudeVector FreeAmplitudes;
+
+    /// derivatives with respect to FreeAmplitudes: the real (imaginary)
+    /// part of each element is the derivative with respect to the real
+    /// (imaginary) part of the corresponding free amplitude
+    std::vector<std::complex<double> > FreeAmplitudeGradient;
+
+    /// second derivatives with respect to real and imaginary parts of
+    /// FreeAmplitudes, with rows and columns ordered (Re f_0, Im f_0, Re f_1, ...);
+    /// empty unless calculated by #log_likelihood_hessian
+    std::vector<std::vector<double> > FreeAmplitudeHessian;
+
+    /// non-fixed admixtures, in order of the Model's components
+    NonnegativeRealParameterVector Admixtures;
+
+    /// derivatives with respect to Admixtures
+    std::vector<double> AdmixtureGradient;
+};
+
+/// \return log-likelihood and its gradient, calculated in one pass over the data
+/// \param M Model to evaluate
+/// \param D DataPartition to evaluate over
+/// \param MI ModelIntegral of M, up to date with its parameters, to normalize with
+/// \param n_threads maximum number of RecalculableDataAccessor's to calculate concurrently
+const LogLikelihood log_likelihood(const Model& M, DataPartition& D, const ModelIntegral& MI, unsigned n_threads = 1);
+
+/// \return log-likelihood and its gradient, calculated in one pass over the data
+/// partitions, each in its own thread
+/// \param M Model to evaluate
+/// \param DP DataPartitionVector of partitions to evaluate over
+/// \param MI ModelIntegral of M, up to date with its parameters, to normalize with
+const LogLikelihood log_likelihood(const Model& M, DataPartitionVector& DP, const ModelIntegral& MI);
+
+/// \return log-likelihood, its gradient, and its Hessian with respect to
+/// free amplitudes, calculated in one pass over the data
+/// \param M Model to evaluate
+/// \param D DataPartition to evaluate over
+/// \param MI ModelIntegral of M, up to date with its parameters, to normalize with
+/// \param n_threads maximum number of RecalculableDataAccessor's to calculate concurrently
+const LogLikelihood log_likelihood_hessian(const Model& M, DataPartition& D, const ModelIntegral& MI, unsigned n_threads = 1);
+
+/// \return log-likelihood, its gradient, and its Hessian with respect to
+/// free amplitudes, calculated in one pass over the data partitions,
+/// each in its own thread
+/// \param M Model to evaluate
+/// \param DP DataPartitionVector of partitions to evaluate over
+/// \param MI ModelIntegral of M, up to date with its parameters, to normalize with
+const LogLikelihood log_likelihood_hessian(const Model& M, DataPartitionVector& DP, const ModelIntegral& MI);
+
+}
+
+#endif
@@ -21,8 +21,10 @@
 #ifndef yap_MassShape_h
 #define yap_MassShape_h
 
+#include "fwd/AmplitudePlan.h"
 #include "fwd/CachedValue.h"
 #include "fwd/DataPartition.h"
+#include "fwd/DataPoint.h"
 #include "fwd/DecayChannel.h"
 #include "fwd/DecayingParticle.h"
 #include "fwd/DecayTree.h"
@@ -36,17 +38,53 @@
 #include <complex>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace yap {
 
+/// \struct MassShapeBatch
+/// \brief Invariant masses of a batch of consecutive data points, gathered
+/// into contiguous arrays, and the array of amplitudes calculated for them
+/// \author Daniel Greenwald
+/// \ingroup MassShapes
+struct MassShapeBatch
+{
+    /// Constructor
+    /// \param n_daughters number of daughters of particle combinations of batch
+    explicit MassShapeBatch(size_t n_daughters);
+
+    /// number of data points in batch
+    size_t Size;
+
+    /// invariant masses of particle combination
+    std::vector<double> M;
+
+    /// squared invariant masses of particle combination
+    std::vector<double> M2;
+
+    /// invariant masses of daughters of particle combination, by daughter
+    std::vector<std::vector<double> > DaughterM;
+
+    /// dynamic amplitudes, to be filled by MassShape::calculateT
+    std::vector<std::complex<double> > T;
+};
+
 /// \class MassShape
 /// \brief Abstract base class for all mass shapes
 /// \author Johannes Rauch, Daniel Greenwald
 /// \defgroup MassShapes Mass Shapes
+///
+/// Mass shapes calculate in batches: for each batch of data points the
+/// invariant masses needed are gathered into contiguous arrays, the
+/// derived class's calculateT fills a contiguous array of amplitudes from
+/// them, which are then stored into the data points.
 class MassShape : public RecalculableAmplitudeComponent
 {
 public:
 
+    /// maximum number of data points in a batch
+    static constexpr size_t batch_size = 256;
+
     /// Constructor
     MassShape();
 
@@ -59,8 +97,20 @@ public:
     /// \param D DataPartition to calculate on
     /// \param pc ParticleCombination to calculate for
     /// \param si SymmetrizationIndec to calculate for
-    virtual void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const = 0;
-    
+    void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const;
+
+    /// mark dynamic amplitudes for recalculation
+    virtual void updateCalculationStatus(StatusManager& D) const override;
+
+    /// \return value for DataPoint and ParticleCombination
+    /// \param d DataPoint
+    /// \param pc shared_ptr to ParticleCombination
+    virtual const std::complex<double> value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const override;
+
+    /// \return AmplitudeFactor reading the cached mass-shape value
+    /// \param pc shared_ptr to ParticleCombination
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc) const override;
+
     /// Check consistency of object
     virtual bool consistent() const override;
 
@@ -81,6 +131,21 @@ public:
 
 protected:
 
+    /// Calculate dynamic amplitudes for a batch of data points
+    /// \param B MassShapeBatch holding masses, whose amplitudes T to fill
+    /// \param first iterator to first data point of batch, for gathering further inputs
+    /// \param pc ParticleCombination to calculate for
+    virtual void calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const = 0;
+
+    /// \return whether calculateT reads MassShapeBatch::DaughterM;
+    /// if not, daughter masses are not gathered
+    virtual bool requiresDaughterMasses() const
+    { return false; }
+
+    /// access cached dynamic amplitude
+    const std::shared_ptr<ComplexCachedValue> T() const
+    { return T_; }
+
     /// Set raw pointer to owner
     virtual void setOwner(DecayingParticle* dp);
 
@@ -97,6 +162,9 @@ protected:
 
 private:
 
+    /// cached dynamic amplitude
+    std::shared_ptr<ComplexCachedValue> T_;
+
     /// raw pointer to owner
     DecayingParticle* Owner_;
 
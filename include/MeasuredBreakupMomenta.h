@@ -21,9 +21,16 @@
 #ifndef yap_MeasuredBreakupMomenta_h
 #define yap_MeasuredBreakupMomenta_h
 
+#include "fwd/MeasuredBreakupMomenta.h"
+
+#include "fwd/CachedValue.h"
+#include "fwd/DataPartition.h"
 #include "fwd/DataPoint.h"
 #include "fwd/Model.h"
 #include "fwd/ParticleCombination.h"
+#include "fwd/StatusManager.h"
+
+#include "StaticDataAccessor.h"
 
 #include <cmath>
 #include <memory>
@@ -39,7 +46,7 @@ namespace measured_breakup_momenta
     /// Access squared breakup momentum
     /// \param d DataPoint to get data from
     /// \param pc ParticleCombination to return breakup momentum of
-    /// \param m Model to use FourMomenta manager from
+    /// \param m Model to use MeasuredBreakupMomenta manager from
     double q2(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc, const Model& m);
 
     /// Access breakup momentum
@@ -55,6 +62,74 @@ namespace measured_breakup_momenta
     double q2(double m2_R, double m_a, double m_b);
 }
 
+/// \class MeasuredBreakupMomenta
+/// \brief Stores and gives access to measured breakup momenta
+/// of all two-body particle combinations
+/// \author Johannes Rauch, Daniel Greenwald
+///
+/// Breakup momenta are calculated once from the invariant masses
+/// stored by FourMomenta, when final-state momenta are set, and
+/// are read by all mass shapes and barrier factors.
+class MeasuredBreakupMomenta : public StaticDataAccessor
+{
+public:
+
+    /// Constructor
+    /// \param m Owning model
+    MeasuredBreakupMomenta(Model& m);
+
+    /// Calculate breakup momenta from invariant masses in DataPoint
+    /// \param d DataPoint to fill
+    /// \param sm StatusManager to update
+    virtual void calculate(DataPoint& d, StatusManager& sm) const override;
+
+    /// \name Getters
+    /// @{
+
+    /// Access squared breakup momentum
+    /// \param d DataPoint to get data from
+    /// \param pc ParticleCombination to return squared breakup momentum of
+    double q2(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const;
+
+    /// Access breakup momentum
+    /// \param d DataPoint to get data from
+    /// \param pc ParticleCombination to return breakup momentum of
+    double q(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const;
+
+    /// Gather squared breakup momenta of consecutive data points into an array
+    /// \param first iterator to first DataPoint to get data from
+    /// \param n number of data points
+    /// \param pc ParticleCombination to return squared breakup momenta of
+    /// \param q2 array of (at least) n values to fill
+    void q2(DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc, double* q2) const;
+
+    /// Gather breakup momenta of consecutive data points into an array
+    /// \param first iterator to first DataPoint to get data from
+    /// \param n number of data points
+    /// \param pc ParticleCombination to return breakup momenta of
+    /// \param q array of (at least) n values to fill
+    void q(DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc, double* q) const;
+
+    /// @}
+
+    /// grant friend status to Model to call addParticleCombination
+    friend class Model;
+
+protected:
+
+    /// adds only two-body ParticleCombination's
+    void addParticleCombination(const ParticleCombination& pc) override;
+
+private:
+
+    /// squared breakup momenta of particle combinations [GeV^2]
+    std::shared_ptr<RealCachedValue> Q2_;
+
+    /// breakup momenta of particle combinations [GeV]
+    std::shared_ptr<RealCachedValue> Q_;
+
+};
+
 }
 
 #endif
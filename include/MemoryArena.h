@@ -0,0 +1,103 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_MemoryArena_h
+#define yap_MemoryArena_h
+
+#include "fwd/MemoryArena.h"
+
+#include <cstddef>
+#include <mutex>
+
+namespace yap {
+
+/// \class MemoryArena
+/// \brief One large block of memory from which storage is carved by bumping a pointer
+/// \author Johannes Rauch, Daniel Greenwald
+/// \ingroup Data
+///
+/// The block is reserved as anonymous virtual memory, so pages are only
+/// committed when first touched and an arena can be sized generously.
+/// Memory is only returned to the system when the arena is destroyed;
+/// releasing the most recently carved piece makes it available again.
+class MemoryArena
+{
+public:
+
+    /// Constructor
+    /// \param bytes size of block to reserve
+    /// \param huge_pages whether to advise the kernel to back the block with huge pages
+    explicit MemoryArena(size_t bytes, bool huge_pages = false);
+
+    /// Destructor, releases the block
+    ~MemoryArena();
+
+    /// copy constructor (deleted)
+    MemoryArena(const MemoryArena&) = delete;
+
+    /// copy assignment operator (deleted)
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    /// carve memory from arena
+    /// \return pointer to memory, or nullptr if arena is exhausted
+    /// \param bytes number of bytes to carve
+    /// \param alignment alignment of returned memory in bytes (must be power of 2)
+    void* allocate(size_t bytes, size_t alignment);
+
+    /// return memory to arena;
+    /// it is reused only if it was the last piece carved
+    /// \param p pointer returned by #allocate
+    /// \param bytes number of bytes requested from #allocate
+    void deallocate(void* p, size_t bytes);
+
+    /// \return whether p lies inside arena
+    bool owns(const void* p) const
+    { return static_cast<const char*>(p) >= Begin_ and static_cast<const char*>(p) < Begin_ + Size_; }
+
+    /// advise the kernel that the arena will be accessed sequentially
+    void adviseSequential();
+
+    /// \return size of arena in bytes
+    size_t size() const
+    { return Size_; }
+
+    /// \return number of bytes carved from arena
+    size_t used() const
+    { return Top_ - Begin_; }
+
+private:
+
+    /// beginning of block
+    char* Begin_;
+
+    /// size of block
+    size_t Size_;
+
+    /// first free byte of block
+    char* Top_;
+
+    /// mutex for carving memory
+    std::mutex Mutex_;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/// \file
+
+#ifndef yap_Minimizer_h
+#define yap_Minimizer_h
+
+#include "fwd/Minimizer.h"
+
+#include "fwd/DataPartition.h"
+#include "fwd/FreeAmplitude.h"
+#include "fwd/Model.h"
+#include "fwd/ModelIntegral.h"
+#include "fwd/Parameter.h"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace yap {
+
+/// \class Minimizer
+/// \brief Maximizes the likelihood of a Model by bounded quasi-Newton
+/// minimization of its negative log-likelihood
+/// \author Daniel Greenwald
+///
+/// The parameters minimized over are the real and imaginary parts of
+/// the Model's non-fixed FreeAmplitude's and its non-fixed
+/// ModelComponent admixtures, whose derivatives are calculated
+/// analytically (see log_likelihood), and the shape parameters added
+/// with #addParameter, whose derivatives are calculated by central
+/// finite differences. Since shape parameters change the integral of
+/// the Model, they may only be added if integration partitions are
+/// given, over which the ModelIntegral is recalculated as needed.
+///
+/// Minimization follows the limited-memory BFGS method with box
+/// bounds (L-BFGS-B): the search direction is the limited-memory
+/// quasi-Newton step in the parameters not held at a bound, and the
+/// line search backtracks along that step projected onto the
+/// bounds. Admixtures and shape parameters that are
+/// NonnegativeRealParameter's are bounded below by zero.
+class Minimizer
+{
+public:
+
+    /// Constructor
+    /// \param M Model to fit
+    /// \param fit_partitions DataPartitionVector of data to fit to
+    /// \param MI ModelIntegral of M
+    /// \param integration_partitions DataPartitionVector of data to recalculate MI with
+    Minimizer(Model& M, DataPartitionVector fit_partitions, ModelIntegral& MI,
+              DataPartitionVector integration_partitions = DataPartitionVector());
+
+    /// add a real shape parameter to minimize over
+    /// \param P RealParameter
+    /// \param low lower bound (raised to zero for a NonnegativeRealParameter,
+    /// and to the smallest positive double for a PositiveRealParameter)
+    /// \param high upper bound
+    void addParameter(std::shared_ptr<RealParameter> P,
+                      double low = -std::numeric_limits<double>::infinity(),
+                      double high = std::numeric_limits<double>::infinity());
+
+    /// add a complex shape parameter to minimize over
+    /// \param P ComplexParameter
+    void addParameter(std::shared_ptr<ComplexParameter> P);
+
+    /// minimize from the current values of the parameters, leaving
+    /// them at the values found
+    /// \return log-likelihood at values found
+    const double minimize();
+
+    /// \return number of iterations of last minimization
+    const unsigned iterations() const
+    { return Iterations_; }
+
+    /// \return number of likelihood calculations of last minimization
+    const unsigned likelihoodCalls() const
+    { return LikelihoodCalls_; }
+
+    /// \return whether last minimization converged
+    const bool converged() const
+    { return Converged_; }
+
+    /// set maximum number of iterations
+    void setMaxIterations(unsigned n)
+    { MaxIterations_ = n; }
+
+    /// set number of corrections stored to approximate the inverse Hessian
+    void setHistorySize(unsigned m)
+    { HistorySize_ = m; }
+
+    /// set tolerance on largest component of the projected gradient
+    void setGradientTolerance(double tol)
+    { GradientTolerance_ = tol; }
+
+    /// set tolerance on relative reduction of the negative log-likelihood in one iteration
+    void setRelativeTolerance(double tol)
+    { RelativeTolerance_ = tol; }
+
+    /// set step of finite differences, relative to the magnitude of a shape parameter
+    void setFiniteDifferenceStep(double h)
+    { FiniteDifferenceStep_ = h; }
+
+private:
+
+    /// set parameter values into Model, and recalculate ModelIntegral if needed
+    /// \param x values of parameters
+    void setValues(const std::vector<double>& x);
+
+    /// \return negative log-likelihood
+    /// \param x values of parameters
+    /// \param g gradient to fill
+    double evaluate(const std::vector<double>& x, std::vector<double>& g);
+
+    /// Model to fit
+    Model* Model_;
+
+    /// data to fit to
+    DataPartitionVector FitPartitions_;
+
+    /// integral of Model
+    ModelIntegral* Integral_;
+
+    /// data to integrate over
+    DataPartitionVector IntegrationPartitions_;
+
+    /// non-fixed free amplitudes, in order of log_likelihood
+    FreeAmplitudeVector FreeAmplitudes_;
+
+    /// non-fixed admixtures, in order of log_likelihood
+    NonnegativeRealParameterVector Admixtures_;
+
+    /// shape parameters
+    ParameterVector ShapeParameters_;
+
+    /// lower bounds of components of shape parameters
+    std::vector<double> ShapeLow_;
+
+    /// upper bounds of components of shape parameters
+    std::vector<double> ShapeHigh_;
+
+    /// maximum number of iterations
+    unsigned MaxIterations_;
+
+    /// number of corrections stored
+    unsigned HistorySize_;
+
+    /// tolerance on projected gradient
+    double GradientTolerance_;
+
+    /// tolerance on relative reduction of negative log-likelihood
+    double RelativeTolerance_;
+
+    /// relative step of finite differences
+    double FiniteDifferenceStep_;
+
+    /// number of iterations of last minimization
+    unsigned Iterations_;
+
+    /// number of likelihood calculations of last minimization
+    unsigned LikelihoodCalls_;
+
+    /// whether last minimization converged
+    bool Converged_;
+
+};
+
+}
+
+#endif
@@ -23,6 +23,8 @@
 
 #include "fwd/Model.h"
 
+#include "fwd/AmplitudeMatrix.h"
+#include "fwd/AmplitudePlan.h"
 #include "fwd/DataAccessor.h"
 #include "fwd/DataPartition.h"
 #include "fwd/DataPoint.h"
@@ -33,18 +35,23 @@
 #include "fwd/FourMomenta.h"
 #include "fwd/FourVector.h"
 #include "fwd/FreeAmplitude.h"
+#include "fwd/HelicityAngles.h"
 #include "fwd/MassAxes.h"
+#include "fwd/MeasuredBreakupMomenta.h"
+#include "fwd/MemoryArena.h"
 #include "fwd/Parameter.h"
 #include "fwd/Particle.h"
 #include "fwd/RecalculableDataAccessor.h"
 #include "fwd/StaticDataAccessor.h"
+#include "fwd/StaticDataCache.h"
 #include "fwd/StatusManager.h"
 
+#include "CalculationGraph.h"
 #include "CoordinateSystem.h"
 #include "Filter.h"
-#include "HelicityAngles.h"
 #include "ParticleCombinationCache.h"
 #include "SpinAmplitudeCache.h"
+#include "StoragePrecision.h"
 
 #include <complex>
 #include <memory>
@@ -65,6 +72,10 @@ public:
     const DecayTreeVector& decayTrees() const
     { return DecayTrees_; }
 
+    /// \return AmplitudePlan compiled from DecayTrees (nullptr until Model is locked)
+    const std::shared_ptr<const AmplitudePlan>& amplitudePlan() const
+    { return AmplitudePlan_; }
+
     /// \return Admixture_ (const)
     const std::shared_ptr<NonnegativeRealParameter>& admixture() const
     { return Admixture_; }
@@ -79,6 +90,12 @@ private:
 
     /// incoherent sum admixture (real) multiplying intensity of DecayTrees
     std::shared_ptr<NonnegativeRealParameter> Admixture_;
+
+    /// evaluation plan compiled from DecayTrees
+    std::shared_ptr<const AmplitudePlan> AmplitudePlan_;
+
+    /// grant friend status to Model to compile AmplitudePlan_
+    friend class Model;
 };
 
 /// \class Model
@@ -113,8 +130,9 @@ public:
     
     /// Calculate model for each data point in the data partition
     /// \param D DataPartition to calculate over
+    /// \param n_threads maximum number of RecalculableDataAccessor's to calculate concurrently
     /// \todo This need not be a member function!
-    void calculate(DataPartition& D) const;
+    void calculate(DataPartition& D, unsigned n_threads = 1) const;
 
     /// Check consistency of object
     virtual bool consistent() const;
@@ -125,6 +143,7 @@ public:
 
     /// prepare model and mark as locked:
     /// removes expired DataAccessor's, prune's remaining, and assigns them indices;
+    /// builds graph of dependencies among RecalculableDataAccessor's;
     /// fixes amplitudes that needn't be free
     void lock();
 
@@ -143,9 +162,17 @@ public:
     const std::shared_ptr<FourMomenta> fourMomenta() const
     { return FourMomenta_; }
 
+    /// \return MeasuredBreakupMomenta accessor (const)
+    const std::shared_ptr<MeasuredBreakupMomenta> measuredBreakupMomenta() const
+    { return MeasuredBreakupMomenta_; }
+
     /// \return HelicityAngles accessor
+    HelicityAngles& helicityAngles()
+    { return *HelicityAngles_; }
+
+    /// \return HelicityAngles accessor (const)
     const HelicityAngles& helicityAngles() const
-    { return HelicityAngles_; }
+    { return *HelicityAngles_; }
 
     /// \return ParticleCombinationCache
     ParticleCombinationCache& particleCombinationCache() const
@@ -175,6 +202,10 @@ public:
     const DataAccessorSet& dataAccessors() const
     { return DataAccessors_; }
 
+    /// \return graph of dependencies among RecalculableDataAccessor's (empty until locked)
+    const CalculationGraph& calculationGraph() const
+    { return CalculationGraph_; }
+
     /// @}
 
     /// \name Setters
@@ -227,9 +258,14 @@ public:
 
     /// create an empty data set
     /// \param n Number of empty data points to place inside data set
-    DataSet createDataSet(size_t n = 0);
-
-    /// Set VariableStatus'es of all Parameter's to unchanged, or leave as fixed
+    /// \param precision maximum StoragePrecision of cached values in data set
+    /// \param arena MemoryArena to carve data set storage from (nullptr for heap)
+    DataSet createDataSet(size_t n = 0, StoragePrecision precision = StoragePrecision::double_precision,
+                          std::shared_ptr<MemoryArena> arena = nullptr);
+
+    /// Set VariableStatus'es of all Parameter's to unchanged, or leave as fixed.
+    /// Recalculation is triggered by parameter generations (see ParameterBase),
+    /// so this is only needed when inspecting VariableStatus'es
     void setParameterFlagsToUnchanged();
 
     /// grant friend status to DataAccessor to register itself with this
@@ -246,7 +282,7 @@ public:
 
 protected:
 
-    /// add ParticleCombination to to FourMomenta_
+    /// add ParticleCombination to FourMomenta_ and MeasuredBreakupMomenta_
     /// (along with it's daughters through recursive calling) if it is NOT for a FSP.
     virtual void addParticleCombination(const ParticleCombination& pc);
 
@@ -275,6 +311,9 @@ private:
     /// set of pointers to RecalculableDataAccessors
     RecalculableDataAccessorSet RecalculableDataAccessors_;
 
+    /// RecalculableDataAccessors_ in order of their dependencies
+    CalculationGraph CalculationGraph_;
+
     /// Components of full intensity
     std::vector<ModelComponent> Components_;
     
@@ -287,8 +326,11 @@ private:
     /// four momenta manager
     std::shared_ptr<FourMomenta> FourMomenta_;
 
+    /// breakup momenta manager, calculated from FourMomenta_
+    std::shared_ptr<MeasuredBreakupMomenta> MeasuredBreakupMomenta_;
+
     /// helicity angles manager
-    HelicityAngles HelicityAngles_;
+    std::shared_ptr<HelicityAngles> HelicityAngles_;
 
 };
 
@@ -315,13 +357,34 @@ inline const double intensity(const Model& M, const DataPoint& d)
 /// \param M Model to evaluate
 /// \param D DataPartition to evalue over
 /// \param ped Pedestal to substract from each term in the sum
-const double sum_of_log_intensity(const Model& M, DataPartition& D, double ped = 0);
+/// \param n_threads maximum number of RecalculableDataAccessor's to calculate concurrently
+const double sum_of_log_intensity(const Model& M, DataPartition& D, double ped = 0, unsigned n_threads = 1);
 
 /// \return The sum of the logs of squared amplitudes evaluated over the data partitions
 /// \param DP DataPartitionVector of partitions to use
 /// \param ped Pedestal to substract from each term in the sum
 const double sum_of_log_intensity(const Model& M, DataPartitionVector& DP, double ped = 0);
 
+/// \return The sum of the logs of squared amplitudes evaluated over the data partition of an
+/// AmplitudeMatrix, which is first updated, as a matrix-vector product of its stored
+/// data-dependent amplitudes with the data-independent amplitudes of the model
+/// \param M Model to evaluate
+/// \param A AmplitudeMatrix of model over data partition
+/// \param ped Pedestal to substract from each term in the sum
+/// \param n_threads maximum number of RecalculableDataAccessor's to calculate concurrently
+const double sum_of_log_intensity(const Model& M, AmplitudeMatrix& A, double ped = 0, unsigned n_threads = 1);
+
+/// \return The sum of the logs of squared amplitudes evaluated over the data points of a
+/// StaticDataCache, streamed through memory in chunks: while one chunk is calculated,
+/// the next is read from disk, and calculated chunks are dropped from memory.
+/// \param M Model to evaluate
+/// \param cache StaticDataCache holding the data points
+/// \param chunk_size number of data points per chunk
+/// \param n_partitions number of DataPartition's (and threads) to calculate each chunk with
+/// \param ped Pedestal to substract from each term in the sum
+const double sum_of_log_intensity(const Model& M, std::shared_ptr<StaticDataCache> cache, size_t chunk_size,
+                                  unsigned n_partitions = 1, double ped = 0);
+
 /// \return all free amplitudes in a model
 FreeAmplitudeSet free_amplitudes(const Model& M);
 
@@ -53,13 +53,13 @@ public:
     /// \param pde ParticleTableEntry to take mass and width from
     NonrelativisticConstantWidthBreitWigner(const ParticleTableEntry& pde) : ConstantWidthBreitWigner(pde) {}
 
-    using ConstantWidthBreitWigner::calculate;
-    
-    /// Calculate dynamic amplitude T for and store in each DataPoint in DataPartition
-    /// \param D DataPartition to calculate on
+protected:
+
+    /// Calculate dynamic amplitudes for a batch of data points
+    /// \param B MassShapeBatch holding masses, whose amplitudes T to fill
+    /// \param first iterator to first data point of batch
     /// \param pc ParticleCombination to calculate for
-    /// \param si SymmetrizationIndec to calculate for
-    virtual void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const override;
+    virtual void calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const override;
 
 };
 
@@ -23,6 +23,8 @@
 
 #include "fwd/Parameter.h"
 
+#include "fwd/RecalculableDataAccessor.h"
+
 #include "Exceptions.h"
 #include "VariableStatus.h"
 
@@ -30,6 +32,7 @@
 #include <complex>
 #include <memory>
 #include <numeric>
+#include <vector>
 
 namespace yap {
 
@@ -37,15 +40,35 @@ namespace yap {
 /// \brief Class holding basic properties of a parameter, but not a value!
 /// \author Johannes Rauch, Daniel Greenwald
 /// \defgroup Parameters
+///
+/// Each change of value increases the parameter's generation and is
+/// pushed to the RecalculableDataAccessor's subscribed to it (those
+/// having it in their parameters), so that only they are marked for
+/// recalculation.
 class ParameterBase
 {
 protected:
 
     /// Constructor
-    ParameterBase() : VariableStatus_(VariableStatus::changed) {}
+    ParameterBase() : VariableStatus_(VariableStatus::changed), Generation_(0) {}
+
+    /// copy constructor: copies status, but not subscribers
+    ParameterBase(const ParameterBase& other) : VariableStatus_(other.VariableStatus_), Generation_(other.Generation_) {}
+
+    /// copy assignment: copies status, keeps subscribers and notifies them
+    ParameterBase& operator=(const ParameterBase& other)
+    { VariableStatus_ = other.VariableStatus_; notifySubscribers(); return *this; }
+
+    /// set VariableStatus to changed, increase generation, and notify subscribers
+    /// \return VariableStatus::changed
+    const VariableStatus setChanged()
+    { VariableStatus_ = VariableStatus::changed; notifySubscribers(); return VariableStatus_; }
 
 public:
 
+    /// virtual destructor
+    virtual ~ParameterBase() = default;
+
     /// \return VariableStatus
     VariableStatus& variableStatus()
     { return VariableStatus_; }
@@ -60,11 +83,27 @@ public:
     /// Set value from vector
     virtual const VariableStatus setValue(const std::vector<double>& V) = 0;
 
+    /// \return number of times value has changed
+    unsigned generation() const
+    { return Generation_; }
+
+    /// grant friend status to RecalculableDataAccessor to subscribe to changes
+    friend class RecalculableDataAccessor;
+
 private:
 
+    /// increase generation and notify subscribers
+    void notifySubscribers();
+
     /// Status of variable
     VariableStatus VariableStatus_;
 
+    /// number of times value has changed
+    unsigned Generation_;
+
+    /// RecalculableDataAccessor's to notify of changes
+    RecalculableDataAccessorVector Subscribers_;
+
 };
 
 /// \return VariableStatus::changed if any element in range is changed; VariableStatus::unchanged otherwise
@@ -123,7 +162,7 @@ public:
         if (ParameterValue_ == val)
             return variableStatus();
         ParameterValue_ = val;
-        return variableStatus() = VariableStatus::changed;
+        return setChanged();
     }
 
     /// set value by operator
@@ -45,10 +45,10 @@ class ParticleCombination : public std::enable_shared_from_this<ParticleCombinat
 private:
 
     /// default constructor
-    ParticleCombination() = default;
+    ParticleCombination() : Index_(-1) {}
 
     /// Final-state-particle constructor, see ParticleCombinationCache::fsp for details
-    explicit ParticleCombination(unsigned index) : Indices_(1, index) {}
+    explicit ParticleCombination(unsigned index) : Indices_(1, index), Index_(-1) {}
 
     /// Copy constructor is deleted
     ParticleCombination(const ParticleCombination&) = delete;
@@ -79,6 +79,11 @@ public:
     std::shared_ptr<const ParticleCombination> parent() const
     { return Parent_.lock(); }
 
+    /// \return dense index of ParticleCombination in its Model's cache,
+    /// assigned when the Model is locked (-1 if unassigned)
+    const int index() const
+    { return Index_; }
+
     /// @}
 
     /// Checks consistency of object
@@ -104,6 +109,9 @@ private:
     /// vector indices of daughters
     std::vector<unsigned> Indices_;
 
+    /// dense index in Model's ParticleCombinationCache
+    int Index_;
+
 };
 
 /// \name ParticleCombinationEqualTo functions
@@ -78,6 +78,10 @@ public:
     /// Check consistency of cache.
     bool consistent() const;
 
+    /// assign dense indices [0, n) to the n ParticleCombination's in the cache
+    /// \return number of indices assigned
+    unsigned setIndices();
+
 private:
 
     /// add to cache
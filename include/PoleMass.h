@@ -21,7 +21,7 @@
 #ifndef yap_PoleMass_h
 #define yap_PoleMass_h
 
-#include "fwd/DataPoint.h"
+#include "fwd/DataPartition.h"
 #include "fwd/Parameter.h"
 #include "fwd/ParticleCombination.h"
 #include "fwd/ParticleTable.h"
@@ -60,33 +60,16 @@ public:
     /// Check consistency of object
     virtual bool consistent() const override;
 
-    /// update the calculationStatus for a DataPartition
-    virtual void updateCalculationStatus(StatusManager& D) const override;
-    
-    /// \return value for DataPoint and ParticleCombination
-    /// \param d DataPoint
-    /// \param pc shared_ptr to ParticleCombination
-    virtual const std::complex<double> value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const override;
-
-    using MassShape::calculate;
-    
-    /// Calculate dynamic amplitude T for particular particle combination and store in each DataPoint in DataPartition
-    /// \param D DataPartition to calculate on
-    /// \param pc ParticleCombination to calculate for
-    /// \param si SymmetrizationIndec to calculate for
-    virtual void calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const override;
-
 protected:
 
-    /// access cached dynamic amplitude
-    const std::shared_ptr<ComplexCachedValue> T() const
-    { return T_; }
+    /// Calculate dynamic amplitudes for a batch of data points
+    /// \param B MassShapeBatch holding masses, whose amplitudes T to fill
+    /// \param first iterator to first data point of batch
+    /// \param pc ParticleCombination to calculate for
+    virtual void calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const override;
 
 private:
 
-    /// cached dynamic amplitude
-    std::shared_ptr<ComplexCachedValue> T_;
-
     /// Complex mass [GeV]
     std::shared_ptr<ComplexParameter> Mass_;
 
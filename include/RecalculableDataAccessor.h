@@ -47,15 +47,24 @@ public:
     /// Constructor
     /// \param equal ParticleCombination equality struct for determining index assignments
     explicit RecalculableDataAccessor(const ParticleCombinationEqualTo& equal)
-        : DataAccessor(equal) {}
+        : DataAccessor(equal), Generation_(0) {}
+
+    /// Destructor: unsubscribes from Parameters_
+    virtual ~RecalculableDataAccessor();
 
     /// calculate for every data point in a DataPartition
     /// must be overloaded in derived class
     virtual void calculate(DataPartition& D) const = 0;
 
-    /// update the calculationStatus for a DataPartition
+    /// mark values in a StatusManager for recalculation;
+    /// called by Model when Parameters_ have changed since they were last calculated
     virtual void updateCalculationStatus(StatusManager& D) const = 0;
 
+    /// \return RecalculableDataAccessor's whose values this one uses,
+    /// which the Model calculates before calling calculate on this one
+    virtual RecalculableDataAccessorSet dependencies() const
+    { return RecalculableDataAccessorSet(); }
+
     /// set VariableStatus of all Parameters to unchanged (or leave fixed)
     void setParameterFlagsToUnchanged();
 
@@ -63,20 +72,34 @@ public:
     const ParameterSet& parameters() const
     { return Parameters_; }
 
+    /// \return number of changes to Parameters_ so far
+    unsigned generation() const
+    { return Generation_; }
+
+    /// grant friend status to ParameterBase to notify of changes
+    friend class ParameterBase;
+
 protected:
 
     /// register with Model
     void virtual registerWithModel() override;
 
-    /// add a parameter for evaluating variableStatus
-    void addParameter(std::shared_ptr<ParameterBase> p)
-    { Parameters_.insert(p); }
+    /// add a parameter for evaluating variableStatus,
+    /// and subscribe to its changes
+    void addParameter(std::shared_ptr<ParameterBase> p);
 
 private:
-    
+
+    /// called by a parameter in Parameters_ when it changes
+    void parameterChanged()
+    { ++Generation_; }
+
     /// Parameters of object
     ParameterSet Parameters_;
 
+    /// number of changes to Parameters_ so far
+    unsigned Generation_;
+
 };
 
 }
@@ -23,6 +23,7 @@
 
 #include "fwd/SpinAmplitude.h"
 
+#include "fwd/AmplitudePlan.h"
 #include "fwd/Model.h"
 #include "fwd/ParticleCombination.h"
 #include "fwd/Spin.h"
@@ -36,6 +37,7 @@
 #include <complex>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 namespace yap {
 
@@ -61,8 +63,8 @@ protected:
 public:
 
     /// \typedef AmplitudeSubmap
-    /// \brief maps SpinProjectionVector to ComplexCachedValue
-    using AmplitudeSubmap = std::map<SpinProjectionVector, std::shared_ptr<ComplexCachedValue> >;
+    /// \brief maps SpinProjectionVector to index of amplitude
+    using AmplitudeSubmap = std::map<SpinProjectionVector, unsigned>;
 
     /// \typedef AmplitudeMap
     /// \brief maps parent spin projectin to AmplitudeSubmap
@@ -96,6 +98,12 @@ public:
     /// \return set of daughter spin projections for given initial state spin projection
     const std::set<SpinProjectionVector> twoM(int two_M) const;
 
+    /// \return index of amplitude for spin projections, throws if none is stored
+    /// \param two_M 2 * spin projection of parent
+    /// \param two_m SpinProjectionVector of daughters
+    const unsigned amplitudeIndex(int two_M, const SpinProjectionVector& two_m) const
+    { return AmplitudeIndices_.at(two_M).at(two_m); }
+
     /// @}
 
     /// Calculate spin amplitude for caching.
@@ -115,14 +123,28 @@ public:
     /// \param sm StatusManager to update
     virtual void calculate(DataPoint& d, StatusManager& sm) const override;
 
+    /// \return precalculated complex amplitude
+    /// \param d DataPoint to retrieve value from
+    /// \param pc ParticleCombination to retrieve value for
+    /// \param i index of amplitude, as given by #amplitudeIndex
+    virtual const std::complex<double> amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
+                                                 unsigned i) const
+    { return Amplitudes_[i]->value(d, symmetrizationIndex(pc)); }
+
     /// \return precalculated complex amplitude
     /// \param d DataPoint to retrieve value from
     /// \param pc ParticleCombination to retrieve value for
     /// \param two_M 2 * spin projection of parent
     /// \param two_m SpinProjectionVector of daughters
-    virtual const std::complex<double> amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
+    const std::complex<double> amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
                                          int two_M, const SpinProjectionVector& two_m) const
-    { return Amplitudes_.at(two_M).at(two_m)->value(d, symmetrizationIndex(pc)); }
+    { return amplitude(d, pc, amplitudeIndex(two_M, two_m)); }
+
+    /// \return AmplitudeFactor for evaluation in a compiled AmplitudePlan,
+    /// must be consistent with #amplitude
+    /// \param pc ParticleCombination to read value for
+    /// \param i index of amplitude, as given by #amplitudeIndex
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const;
 
     /// check equivalence: only check spins and angular momenta
     bool equalTo(const SpinAmplitude& other) const;
@@ -143,7 +165,21 @@ protected:
     /// \param two_M twice the spin projection of the initial state
     /// \param two_m SpinProjectionVector of daughters
     /// \param store_null store a NULL CachedValue shared_pointer (set true for use from UnitSpinAmplitude)
-    void addAmplitude(int two_M, const SpinProjectionVector& two_m, bool store_null = false);
+    /// \param bound bound on magnitude of amplitude (0 if unknown), allowing it to be stored as fixed point
+    /// \return index of added amplitude
+    const unsigned addAmplitude(int two_M, const SpinProjectionVector& two_m, bool store_null = false, double bound = 0);
+
+    /// \return cached amplitudes, indexed by amplitude index
+    const std::vector<std::shared_ptr<ComplexCachedValue> >& amplitudes() const
+    { return Amplitudes_; }
+
+    /// \return parent spin projection of i'th amplitude
+    const int initialTwoM(unsigned i) const
+    { return InitialTwoM_[i]; }
+
+    /// \return daughter spin projections of i'th amplitude
+    const SpinProjectionVector& finalTwoM(unsigned i) const
+    { return FinalTwoM_[i]; }
 
 private:
 
@@ -159,8 +195,17 @@ private:
     /// twice the total spin angular momentum
     unsigned TwoS_;
 
-    /// Cached complex spin amplitude
-    AmplitudeMap Amplitudes_;
+    /// maps spin projections to amplitude indices
+    AmplitudeMap AmplitudeIndices_;
+
+    /// Cached complex spin amplitudes, by amplitude index
+    std::vector<std::shared_ptr<ComplexCachedValue> > Amplitudes_;
+
+    /// parent spin projections, by amplitude index
+    std::vector<int> InitialTwoM_;
+
+    /// daughter spin projections, by amplitude index
+    std::vector<SpinProjectionVector> FinalTwoM_;
 
     /// equality operator
     friend bool operator==(const SpinAmplitude& A, const SpinAmplitude& B)
@@ -0,0 +1,224 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_StaticDataCache_h
+#define yap_StaticDataCache_h
+
+#include "fwd/StaticDataCache.h"
+
+#include "fwd/DataSet.h"
+#include "fwd/Model.h"
+
+#include "StoragePrecision.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yap {
+
+/// \class StaticDataCache
+/// \brief Memory-mapped file holding the columns of all StaticDataAccessor's of a DataSet
+/// \author Johannes Rauch, Daniel Greenwald
+/// \ingroup Data
+///
+/// The values of StaticDataAccessor's (four-momenta, spin amplitudes)
+/// depend only on the data point, so they need only be calculated once
+/// per data sample. #write_static_data_cache stores them to a file; a
+/// StaticDataCache maps that file into memory, and DataSet::map uses
+/// its columns directly, without calculating or copying them.
+///
+/// The file holds a header, followed by one column per static column of
+/// the DataSet, each starting on a 64-byte boundary. It is keyed by
+/// #static_data_key of the Model it was written for, and is only valid
+/// for the machine architecture it was written on.
+///
+/// The file is mapped read only; DataColumns copy mapped columns
+/// into their own storage before writing to them.
+class StaticDataCache
+{
+public:
+
+    /// Constructor, maps file
+    /// \param filename name of file written by #write_static_data_cache
+    explicit StaticDataCache(const std::string& filename);
+
+    /// Destructor, unmaps file
+    ~StaticDataCache();
+
+    /// copy constructor (deleted)
+    StaticDataCache(const StaticDataCache&) = delete;
+
+    /// copy assignment operator (deleted)
+    StaticDataCache& operator=(const StaticDataCache&) = delete;
+
+    /// \return key of Model and precision file was written for
+    uint64_t key() const
+    { return Key_; }
+
+    /// \return StoragePrecision of DataSet file was written from
+    StoragePrecision precision() const
+    { return Precision_; }
+
+    /// \return number of data points
+    size_t size() const
+    { return Size_; }
+
+    /// \return number of columns
+    unsigned nColumns() const
+    { return Offsets_.size(); }
+
+    /// \return pointer to first element of column i
+    const void* column(unsigned i) const
+    { return Begin_ + Offsets_[i]; }
+
+    /// \return number of bytes of one element of column i
+    size_t width(unsigned i) const
+    { return Widths_[i]; }
+
+    /// read data points [first, last) from disk into memory, if not already there
+    void prefetch(size_t first, size_t last);
+
+    /// let the kernel drop data points [first, last) from memory;
+    /// they are read from disk again when next accessed, and values written to them are lost
+    void release(size_t first, size_t last);
+
+private:
+
+    /// beginning of mapped file
+    char* Begin_;
+
+    /// size of mapped file in bytes
+    size_t Bytes_;
+
+    /// key of Model and precision
+    uint64_t Key_;
+
+    /// precision of DataSet
+    StoragePrecision Precision_;
+
+    /// number of data points
+    size_t Size_;
+
+    /// position of each column in file
+    std::vector<uint64_t> Offsets_;
+
+    /// number of bytes of one element of each column
+    std::vector<uint64_t> Widths_;
+
+};
+
+/// \class StaticDataCacheWriter
+/// \brief Writes a StaticDataCache file chunk by chunk
+/// \author Johannes Rauch, Daniel Greenwald
+/// \ingroup Data
+///
+/// For samples too large to be held in memory at once: the total number
+/// of data points is given up front, and DataSet's holding consecutive
+/// chunks of them are written one after the other.
+/// The file only appears under its name when #close is called.
+class StaticDataCacheWriter
+{
+public:
+
+    /// Constructor, opens temporary file
+    /// \param M (locked) Model data sets will be created from
+    /// \param precision StoragePrecision of data sets
+    /// \param n total number of data points
+    /// \param filename name of file
+    StaticDataCacheWriter(const Model& M, StoragePrecision precision, size_t n, const std::string& filename);
+
+    /// Destructor, removes temporary file if not closed
+    ~StaticDataCacheWriter();
+
+    /// copy constructor (deleted)
+    StaticDataCacheWriter(const StaticDataCacheWriter&) = delete;
+
+    /// copy assignment operator (deleted)
+    StaticDataCacheWriter& operator=(const StaticDataCacheWriter&) = delete;
+
+    /// write static columns of data points of D behind those written so far
+    /// \param D DataSet of Model and precision given at construction
+    void write(const DataSet& D);
+
+    /// check that all data points have been written, and move file into place
+    void close();
+
+    /// \return number of data points written so far
+    size_t size() const
+    { return Written_; }
+
+private:
+
+    /// Model
+    const Model* Model_;
+
+    /// StoragePrecision
+    StoragePrecision Precision_;
+
+    /// total number of data points
+    size_t Size_;
+
+    /// number of data points written
+    size_t Written_;
+
+    /// name of file
+    std::string Filename_;
+
+    /// temporary file written to
+    std::ofstream Out_;
+
+    /// DataAccessor index and index within DataAccessor of each column
+    std::vector<std::pair<unsigned, unsigned> > Columns_;
+
+    /// position of each column in file
+    std::vector<uint64_t> Offsets_;
+
+    /// number of bytes of one element of each column
+    std::vector<uint64_t> Widths_;
+
+    /// size of file in bytes
+    uint64_t Bytes_;
+
+};
+
+/// \return key identifying the layout of the static columns of a DataSet
+/// of a (locked) Model; two Model's with equal key have equal static columns for equal data
+/// \param M Model
+/// \param precision StoragePrecision of DataSet
+uint64_t static_data_key(const Model& M, StoragePrecision precision);
+
+/// \return DataAccessor index and index within DataAccessor of each
+/// column of the StaticDataAccessor's of a Model, in order of storage in a StaticDataCache
+/// \param M Model
+std::vector<std::pair<unsigned, unsigned> > static_columns(const Model& M);
+
+/// write the static columns of a DataSet to a file that can be mapped by a StaticDataCache;
+/// an existing file is replaced atomically (see StaticDataCacheWriter for writing in chunks)
+/// \param D DataSet to write
+/// \param filename name of file
+void write_static_data_cache(const DataSet& D, const std::string& filename);
+
+}
+
+#endif
@@ -21,66 +21,104 @@
 #ifndef yap_StatusManager_h
 #define yap_StatusManager_h
 
-#include "fwd/CalculationStatus.h"
-#include "fwd/VariableStatus.h"
+#include "fwd/MemoryArena.h"
 
+#include "AlignedAllocator.h"
 #include "CachedValue.h"
+#include "CalculationStatus.h"
 #include "DataAccessor.h"
+#include "VariableStatus.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace yap {
 
+/// \class StatusManager
+/// \brief Holds the statuses of all CachedValue's for all symmetrization indices
+/// \author Johannes Rauch, Daniel Greenwald
+/// \ingroup Data
+///
+/// CalculationStatus'es and VariableStatus'es are stored in two flat
+/// byte tables, ordered by DataAccessor, CachedValue, and symmetrization
+/// index. The position of each CachedValue's statuses is set when the
+/// Model is locked (see CachedValue::statusOffset), so that lookup is a
+/// single index, resetting the CalculationStatus'es is a memset, and
+/// copying a StatusManager is a memcpy of each table.
+///
+/// It also records for each RecalculableDataAccessor the generation of
+/// its parameters that its values were last calculated with (see
+/// Model::calculate).
 class StatusManager
 {
 public:
 
+    /// \struct StatusReference
+    /// \brief Reference to the statuses of a CachedValue for one symmetrization index
+    struct StatusReference {
+
+        /// Calculation status
+        CalculationStatus& Calculation;
+
+        /// Variable status
+        VariableStatus& Variable;
+
+        /// assignment of Calculation
+        StatusReference& operator=(const CalculationStatus& s)
+        { Calculation = s; return *this; }
+
+        /// assignment of Variable;
+        /// does not change Variable if it is fixed!
+        StatusReference& operator=(const VariableStatus& s)
+        { if (Variable != VariableStatus::fixed) Variable = s; return *this; }
+
+        /// conversion to CachedValue::Status
+        operator CachedValue::Status() const
+        { return CachedValue::Status(Calculation, Variable); }
+    };
+
     /// constructor
     /// \param sDA DataAccessorSet to construct StatusManager for
-    StatusManager(const DataAccessorSet& sDA);
+    /// \param arena MemoryArena to carve status tables from (nullptr for heap)
+    StatusManager(const DataAccessorSet& sDA, std::shared_ptr<MemoryArena> arena = nullptr);
 
     /// \name direct access to individual statuses
     /// @{
 
     /// Access status
-    /// \return CachedValue::Status
-    /// \param da_index Index of DataAccessor
-    /// \param cdv_index Index of CachedValue
-    /// \param sym_index Index of symmetrization
-    CachedValue::Status& status(size_t da_index, size_t cdv_index, size_t sym_index)
-    { return Statuses_[da_index][cdv_index][sym_index]; }
-
-    /// retrieve status (const)
-    /// \return CachedValue::Status (const)
-    /// \param da_index Index of DataAccessor
-    /// \param cdv_index Index of CachedValue
-    /// \param sym_index Index of symmetrization
-    const CachedValue::Status& status(size_t da_index, size_t cdv_index, size_t sym_index) const
-    { return const_cast<StatusManager*>(this)->status(da_index, cdv_index, sym_index); }
-
-    /// Access status
-    /// \return CachedValue::Status
+    /// \return StatusReference
     /// \param cdv CachedValue
     /// \param sym_index Index of symmetrization
-    CachedValue::Status& status(const CachedValue& cdv, size_t sym_index);
+    StatusReference status(const CachedValue& cdv, size_t sym_index)
+    { return {Calculations_[cdv.statusOffset() + sym_index], Variables_[cdv.statusOffset() + sym_index]}; }
 
     /// retrieve status (const)
-    /// \return CachedValue::Status (const)
+    /// \return CachedValue::Status
     /// \param cdv CachedValue
     /// \param sym_index Index of symmetrization
-    const CachedValue::Status& status(const CachedValue& cdv, size_t sym_index) const
-    { return const_cast<StatusManager*>(this)->status(cdv, sym_index); }
+    const CachedValue::Status status(const CachedValue& cdv, size_t sym_index) const
+    { return CachedValue::Status(Calculations_[cdv.statusOffset() + sym_index], Variables_[cdv.statusOffset() + sym_index]); }
 
     /// @}
 
+    /// \return generation of the parameters of a DataAccessor its values were last calculated with
+    /// \param da DataAccessor
+    unsigned& generation(const DataAccessor& da)
+    { return Generations_[da.index()]; }
+
+    /// \return generation of the parameters of a DataAccessor its values were last calculated with (const)
+    /// \param da DataAccessor
+    const unsigned generation(const DataAccessor& da) const
+    { return Generations_[da.index()]; }
+
     /// set all statuses for a particular CachedValue
     /// \param cdv CachedValue
     /// \param stat status to set to
     /// \tparam T type of status
     template <class T>
     void set(const CachedValue& cdv, const T& stat)
-    {
-        for (auto& s : Statuses_[cdv.owner()->index()][cdv.index()])
-            s = stat;
-    }
+    { fill(cdv.statusOffset(), cdv.statusOffset() + cdv.owner()->nSymmetrizationIndices(), stat); }
 
     /// set all statuses for all CachedValue's of a DataAccessor
     /// \param da DataAccessor
@@ -88,33 +126,54 @@ public:
     /// \tparam T type of status
     template <class T>
     void set(const DataAccessor& da, const T& stat)
-    {
-        for (auto& v : Statuses_[da.index()])
-            for (auto& s : v)
-                s = stat;
-    }
+    { fill(da.statusOffset(), da.statusOffset() + da.nStatuses(), stat); }
 
     /// set all statuses to a value
     /// \param stat value to set all statuses to
     /// \tparam T type of status
     template <class T>
     void setAll(const T& stat)
+    { fill(0, Calculations_.size(), stat); }
+
+private:
+
+    /// set CalculationStatus'es [first, last)
+    void fill(size_t first, size_t last, CalculationStatus stat)
+    { std::fill(Calculations_.begin() + first, Calculations_.begin() + last, stat); }
+
+    /// set VariableStatus'es [first, last), leaving fixed ones unchanged
+    void fill(size_t first, size_t last, VariableStatus stat)
     {
-        for (auto& v1 : Statuses_)
-            for (auto& v2 : v1)
-                for (auto& s : v2)
-                    s = stat;
+        std::replace_if(Variables_.begin() + first, Variables_.begin() + last,
+                        [](VariableStatus s) {return s != VariableStatus::fixed;}, stat);
     }
 
-private:
+    /// table of CalculationStatus
+    std::vector<CalculationStatus, AlignedAllocator<CalculationStatus> > Calculations_;
+
+    /// table of VariableStatus
+    std::vector<VariableStatus, AlignedAllocator<VariableStatus> > Variables_;
 
-    /// vector of Status;
-    /// first index is for DataAccessor;
-    /// second index is for CachedValue
-    /// third index is for SymmetrizationIndex
-    std::vector<std::vector<std::vector<CachedValue::Status> > > Statuses_;
+    /// generation of parameters values were last calculated with, by DataAccessor index
+    std::vector<unsigned> Generations_;
 
 };
 
+/// equality operator for checking the CalculationStatus
+inline bool operator==(const StatusManager::StatusReference& S, const CalculationStatus& s)
+{ return S.Calculation == s; }
+
+/// inequality operator for checking the CalculationStatus
+inline bool operator!=(const StatusManager::StatusReference& S, const CalculationStatus& s)
+{ return S.Calculation != s; }
+
+/// equality operator for checking the VariableStatus
+inline bool operator==(const StatusManager::StatusReference& S, const VariableStatus& s)
+{ return S.Variable == s; }
+
+/// inequality operator for checking the VariableStatus
+inline bool operator!=(const StatusManager::StatusReference& S, const VariableStatus& s)
+{ return S.Variable != s; }
+
 }
 #endif
@@ -0,0 +1,91 @@
+/*  YAP - Yet another PWA toolkit
+    Copyright 2015, Technische Universitaet Muenchen,
+    Authors: Daniel Greenwald, Johannes Rauch
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// \file
+
+#ifndef yap_StoragePrecision_h
+#define yap_StoragePrecision_h
+
+#include "fwd/StoragePrecision.h"
+
+#include "Exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace yap {
+
+/// \enum StoragePrecision
+/// \brief Precision with which the elements of a CachedValue are stored;
+/// elements are stored with the lower of the precision of the CachedValue and that of the DataSet
+/// \ingroup Cache
+///
+/// Only elements of CachedValue's with a known bound on their magnitude
+/// can be stored as fixed point; others are stored as float instead.
+enum class StoragePrecision : unsigned char {
+    fixed_point = 0,      ///< stored as 16-bit fixed point, relative to bound of CachedValue
+    single_precision = 1, ///< stored as float
+    double_precision = 2  ///< stored as double
+};
+
+/// \return number of bytes used to store one element with precision p
+inline constexpr unsigned bytes_per_element(StoragePrecision p)
+{
+    return p == StoragePrecision::fixed_point ? sizeof(int16_t)
+           : (p == StoragePrecision::single_precision ? sizeof(float) : sizeof(double));
+}
+
+/// largest magnitude of a value stored as fixed point
+constexpr int16_t fixed_point_max = 32767;
+
+/// \return value encoded as fixed point; values beyond bound are clamped to it
+/// \param val value to encode
+/// \param bound bound on magnitude of value
+inline int16_t to_fixed_point(double val, double bound)
+{ return static_cast<int16_t>(std::lround(std::max(-1., std::min(1., val / bound)) * fixed_point_max)); }
+
+/// \return value decoded from fixed point
+/// \param v encoded value
+/// \param bound bound on magnitude of value
+inline double from_fixed_point(int16_t v, double bound)
+{ return v * (bound / fixed_point_max); }
+
+/// \return largest absolute error of a value (within bound) stored as fixed point
+/// \param bound bound on magnitude of value
+inline constexpr double fixed_point_error(double bound)
+{ return 0.5 * bound / fixed_point_max; }
+
+/// convert StoragePrecision to string
+inline std::string to_string(const StoragePrecision& p)
+{
+    switch (p) {
+        case StoragePrecision::fixed_point:
+            return "fixed-point";
+        case StoragePrecision::single_precision:
+            return "single";
+        case StoragePrecision::double_precision:
+            return "double";
+    }
+    throw exceptions::Exception("unknown StoragePrecision", "to_string");
+}
+
+}
+
+#endif
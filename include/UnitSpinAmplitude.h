@@ -41,15 +41,21 @@ public:
                                     const std::shared_ptr<const ParticleCombination>& pc) const override
     { return 1.; }
 
+    using SpinAmplitude::amplitude;
+
     /// \return unit amplitude
     /// \param d dummy DataPoint
     /// \param pc dummy ParticleCombination
-    /// \param two_M 2 * spin projection of parent
-    /// \param two_m SpinProjectionVector of daughters
+    /// \param i dummy amplitude index
     virtual const std::complex<double> amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
-                                                 int two_M, const SpinProjectionVector& two_m) const override
+                                                 unsigned i) const override
     { return 1.; }
 
+    /// \return constant AmplitudeFactor of 1
+    /// \param pc dummy ParticleCombination
+    /// \param i dummy amplitude index
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const override;
+
     /// \return "unit-valued"
     virtual std::string formalism() const override
     { return "unit-valued"; }
@@ -26,7 +26,7 @@
 namespace yap {
 
 /// \enum VariableStatus
-enum class VariableStatus : int {
+enum class VariableStatus : signed char {
     changed   = -1,        ///< Variable is free and has been changed
     fixed     = 0,         ///< Variable is fixed
     unchanged = +1,        ///< Variable is free but has not been changed
@@ -44,6 +44,7 @@
 #include "MathUtilities.h"
 
 #include <complex>
+#include <cstddef>
 
 namespace yap {
 
@@ -60,10 +61,29 @@ inline const std::complex<double> DFunction(unsigned twoJ, int twoM, int twoN, d
 
 namespace dMatrix {
 
-/// Cache d-matrix elements for representation of spin J
+/// maximum twice the spin for which d-matrix elements can be cached
+constexpr unsigned max_twoJ = 64;
+
+/// Cache d-matrix elements for representation of spin J; thread safe
 /// \param twoJ twice the spin of the representation
 void cache(unsigned int twoJ);
 
+/// Calculate all elements of the d-matrix of spin J for a block of
+/// angles, in one pass per angle
+/// \param twoJ twice the spin of the representation
+/// \param beta array of n rotation angles
+/// \param n number of rotation angles
+/// \param d array of (2J + 1)^2 * n values to fill;
+/// \f$ d^{J}_{MN}(\beta_i) \f$ is stored at #index(twoJ, twoM, twoN) * n + i
+void calculate(unsigned twoJ, const double* beta, size_t n, double* d);
+
+/// \return index of matrix element in arrays filled by #calculate
+/// \param twoJ twice the spin of the representation
+/// \param twoM twice the first spin projection
+/// \param twoN twice the second spin projection
+constexpr unsigned index(unsigned twoJ, int twoM, int twoN)
+{ return (twoJ + twoM) / 2 * (twoJ + 1) + (twoJ + twoN) / 2; }
+
 /// \return cache size in bytes
 const unsigned cacheSize();
 
@@ -53,13 +53,19 @@ protected:
 
 public:
 
+    using SpinAmplitude::amplitude;
+
     /// \return precalculated complex amplitude
     /// \param d DataPoint to retrieve value from
     /// \param pc ParticleCombination to retrieve value for
-    /// \param two_M 2 * spin projection of parent
-    /// \param two_m SpinProjectionVector of daughters
+    /// \param i index of amplitude
     virtual const std::complex<double> amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
-                                                 int two_M, const SpinProjectionVector& two_m) const override;
+                                                 unsigned i) const override;
+
+    /// \return AmplitudeFactor, constant where #amplitude is 1
+    /// \param pc ParticleCombination to read value for
+    /// \param i index of amplitude
+    virtual AmplitudeFactor factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const override;
     
     /// Overrides SpinAmplitude::calculate to do nothing if twoS() == 0
     /// \param d DataPoint to calculate into
@@ -24,7 +24,7 @@
 
 namespace yap {
 
-enum class VariableStatus : int;
+enum class VariableStatus : signed char;
 
 }
 
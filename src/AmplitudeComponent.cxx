@@ -1,10 +1,17 @@
 #include "AmplitudeComponent.h"
 
+#include "AmplitudePlan.h"
 #include "Parameter.h"
 #include "ParticleCombination.h"
 
 namespace yap {
 
+//-------------------------
+AmplitudeFactor AmplitudeComponent::factor(const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    return AmplitudeFactor(*this, pc);
+}
+
 //-------------------------
 const bool StaticAmplitudeComponent::validFor(const ParticleCombination& pc) const
 {
@@ -0,0 +1,75 @@
+#include "AmplitudeMatrix.h"
+
+#include "AmplitudePlan.h"
+#include "DataPartition.h"
+#include "DataPoint.h"
+#include "Exceptions.h"
+#include "Model.h"
+
+namespace yap {
+
+//-------------------------
+AmplitudeMatrix::AmplitudeMatrix(const Model& M, DataPartition& D) :
+    Model_(&M),
+    DataPartition_(&D),
+    Rows_(0)
+{
+    if (!M.locked())
+        throw exceptions::Exception("Model is not locked", "AmplitudeMatrix::AmplitudeMatrix");
+
+    Columns_.reserve(M.components().size());
+    Generations_.reserve(M.components().size());
+    for (const auto& c : M.components()) {
+        Columns_.emplace_back(c.amplitudePlan()->size());
+        Generations_.emplace_back(c.amplitudePlan()->size());
+    }
+
+    invalidate();
+}
+
+//-------------------------
+void AmplitudeMatrix::invalidate()
+{
+    // start out of date
+    for (size_t c = 0; c < Generations_.size(); ++c)
+        for (size_t k = 0; k < Generations_[c].size(); ++k)
+            Generations_[c][k] = Model_->components()[c].amplitudePlan()->generation(k) - 1;
+}
+
+//-------------------------
+void AmplitudeMatrix::update(unsigned n_threads)
+{
+    size_t N = DataPartition_->end() - DataPartition_->begin();
+    if (N != Rows_) {
+        Rows_ = N;
+        invalidate();
+    }
+
+    bool calculated = false;
+
+    for (size_t c = 0; c < Columns_.size(); ++c) {
+        const auto& plan = *Model_->components()[c].amplitudePlan();
+
+        for (size_t k = 0; k < Columns_[c].size(); ++k) {
+            auto g = plan.generation(k);
+            if (g == Generations_[c][k])
+                continue;
+
+            // bring cached values of Model up to date, once
+            if (!calculated) {
+                Model_->calculate(*DataPartition_, n_threads);
+                calculated = true;
+            }
+
+            auto& col = Columns_[c][k];
+            col.resize(Rows_);
+            size_t i = 0;
+            for (const auto& d : *DataPartition_)
+                col[i++] = plan.dataDependentAmplitude(d, k);
+
+            Generations_[c][k] = g;
+        }
+    }
+}
+
+}
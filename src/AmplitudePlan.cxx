@@ -0,0 +1,156 @@
+#include "AmplitudePlan.h"
+
+#include "AmplitudeComponent.h"
+#include "DecayChannel.h"
+#include "DecayTree.h"
+#include "FreeAmplitude.h"
+#include "ParticleCombination.h"
+#include "RecalculableDataAccessor.h"
+#include "SpinAmplitude.h"
+
+#include <numeric>
+#include <set>
+
+namespace yap {
+
+namespace {
+
+// append free amplitudes of decay tree and all its daughters' decay trees,
+// including repeats, since dataIndependentAmplitude multiplies by each
+void append_free_amplitudes(const DecayTree& dt, FreeAmplitudeVector& fav)
+{
+    fav.push_back(dt.freeAmplitude());
+    for (const auto& d_dt : dt.daughterDecayTrees())
+        append_free_amplitudes(*d_dt.second, fav);
+}
+
+// insert accessor and (recursively) those it depends on into S
+void insert_recalculable_data_accessor(const RecalculableDataAccessor* rda, std::set<const RecalculableDataAccessor*>& S)
+{
+    if (!S.insert(rda).second)
+        return;
+    for (const auto& dep : rda->dependencies())
+        insert_recalculable_data_accessor(dep, S);
+}
+
+// insert recalculable amplitude components of a DecayTree and its daughters into S
+void insert_recalculable_data_accessors(const DecayTree& dt, std::set<const RecalculableDataAccessor*>& S)
+{
+    for (const auto& ac : dt.amplitudeComponents()) {
+        auto rda = dynamic_cast<const RecalculableDataAccessor*>(ac);
+        if (rda)
+            insert_recalculable_data_accessor(rda, S);
+    }
+    for (const auto& d_dt : dt.daughterDecayTrees())
+        insert_recalculable_data_accessors(*d_dt.second, S);
+}
+
+}
+
+//-------------------------
+const std::complex<double> AmplitudeFactor::componentValue(const DataPoint& d) const
+{
+    return Component_->value(d, ParticleCombination_);
+}
+
+//-------------------------
+AmplitudePlan::AmplitudePlan(const DecayTreeVector& dtv)
+{
+    TermOffsets_.reserve(dtv.size() + 1);
+    FreeAmplitudes_.reserve(dtv.size());
+    RecalculableDataAccessors_.reserve(dtv.size());
+
+    for (const auto& dt : dtv) {
+
+        TermOffsets_.push_back(Terms_.size());
+
+        FreeAmplitudes_.push_back(FreeAmplitudeVector());
+        append_free_amplitudes(*dt, FreeAmplitudes_.back());
+
+        std::set<const RecalculableDataAccessor*> S;
+        insert_recalculable_data_accessors(*dt, S);
+        RecalculableDataAccessors_.emplace_back(S.begin(), S.end());
+
+        // one term per particle combination of the decay tree's channel
+        for (const auto& pc : dt->freeAmplitude()->decayChannel()->particleCombinations()) {
+            Term t = {1., Factors_.size(), 0};
+            compile(*dt, pc, t.Constant);
+            t.End = Factors_.size();
+
+            // drop terms that are always zero
+            if (t.Constant == 0.)
+                Factors_.erase(Factors_.begin() + t.Begin, Factors_.end());
+            else
+                Terms_.push_back(t);
+        }
+    }
+
+    TermOffsets_.push_back(Terms_.size());
+}
+
+//-------------------------
+void AmplitudePlan::compile(const DecayTree& dt, const std::shared_ptr<const ParticleCombination>& pc, std::complex<double>& c)
+{
+    std::vector<AmplitudeFactor> F;
+    F.reserve(dt.amplitudeComponents().size() + 1);
+
+    // spin amplitude
+    F.push_back(dt.freeAmplitude()->spinAmplitude()->factor(pc, dt.amplitudeIndex()));
+
+    // amplitude components
+    for (const auto& ac : dt.amplitudeComponents())
+        F.push_back(ac->factor(pc));
+
+    // fold constant factors into c
+    for (auto& f : F) {
+        if (f.isConstant())
+            c *= f.constant();
+        else
+            Factors_.push_back(std::move(f));
+    }
+
+    // likewise for daughters
+    for (const auto& d_dt : dt.daughterDecayTrees())
+        compile(*d_dt.second, pc->daughters()[d_dt.first], c);
+}
+
+//-------------------------
+const unsigned AmplitudePlan::generation(size_t i) const
+{
+    return std::accumulate(RecalculableDataAccessors_[i].begin(), RecalculableDataAccessors_[i].end(), 0u,
+                           [](unsigned g, const RecalculableDataAccessor* rda) {return g + rda->generation();});
+}
+
+//-------------------------
+std::vector<std::complex<double> > AmplitudePlan::dataIndependentAmplitudes() const
+{
+    std::vector<std::complex<double> > A(FreeAmplitudes_.size(), 1.);
+    for (size_t i = 0; i < A.size(); ++i)
+        for (const auto& fa : FreeAmplitudes_[i])
+            A[i] *= fa->value();
+    return A;
+}
+
+//-------------------------
+const std::complex<double> AmplitudePlan::dataDependentAmplitude(const DataPoint& d, size_t i) const
+{
+    std::complex<double> A = 0;
+    for (size_t t = TermOffsets_[i]; t < TermOffsets_[i + 1]; ++t) {
+        auto a = Terms_[t].Constant;
+        for (size_t f = Terms_[t].Begin; f < Terms_[t].End; ++f)
+            a *= Factors_[f].value(d);
+        A += a;
+    }
+    return A;
+}
+
+//-------------------------
+const std::complex<double> AmplitudePlan::amplitude(const DataPoint& d, const std::vector<std::complex<double> >& A) const
+{
+    std::complex<double> amp = 0;
+    for (size_t i = 0; i < FreeAmplitudes_.size(); ++i)
+        amp += A[i] * dataDependentAmplitude(d, i);
+    return amp;
+}
+
+}
@@ -1,49 +1,109 @@
 #include "BlattWeisskopf.h"
 
+#include "AmplitudePlan.h"
 #include "CalculationStatus.h"
 #include "DataPartition.h"
 #include "DecayingParticle.h"
 #include "Exceptions.h"
-#include "FourMomenta.h"
 #include "logging.h"
 #include "MeasuredBreakupMomenta.h"
 #include "Model.h"
 #include "Parameter.h"
 #include "ParticleCombination.h"
 
+#include <algorithm>
+#include <array>
+
 namespace yap {
 
+//-------------------------
+const double hankel_squared_barrier_factor(unsigned l, double z)
+{
+    if (l == 0)
+        return 1;
+    if (z <= 0)
+        return 0;
+
+    // g_l(x) := x * h_l(x) / (-i)^(l + 1) / exp(i * x) obeys
+    // g_(l + 1) = i * (2l + 1) / x * g_l + g_(l - 1),
+    // with g_0 = 1 and g_1 = 1 + i / x
+    auto g = [l](double x) {
+        std::complex<double> g_prev(1, 0);
+        std::complex<double> g_l(1, 1 / x);
+        for (unsigned n = 1; n < l; ++n) {
+            auto g_next = std::complex<double>(0, (2 * n + 1) / x) * g_l + g_prev;
+            g_prev = g_l;
+            g_l = g_next;
+        }
+        return std::norm(g_l);
+    };
+
+    return g(1) / g(sqrt(z));
+}
+
 //-------------------------
 const double squared_barrier_factor(unsigned l, double z)
 {
     switch (l) {
     case 0:
-        return 1;
+        return squared_barrier_factor<0>(z);
+    case 1:
+        return squared_barrier_factor<1>(z);
+    case 2:
+        return squared_barrier_factor<2>(z);
+    case 3:
+        return squared_barrier_factor<3>(z);
+    case 4:
+        return squared_barrier_factor<4>(z);
+    case 5:
+        return squared_barrier_factor<5>(z);
+    case 6:
+        return squared_barrier_factor<6>(z);
+    case 7:
+        return squared_barrier_factor<7>(z);
+    default:
+        return hankel_squared_barrier_factor(l, z);
+    }
+}
+
+namespace {
+
+/// squared barrier factors for fixed L, free of branching on L
+template <unsigned L>
+void squared_barrier_factors(double* F2, const double* z, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        F2[i] = squared_barrier_factor<L>(z[i]);
+}
+
+/// number of data points barrier factors are calculated for at once
+constexpr size_t block_size = 256;
+
+}
+
+//-------------------------
+void squared_barrier_factors(unsigned l, double* F2, const double* z, size_t n)
+{
+    switch (l) {
+    case 0:
+        return squared_barrier_factors<0>(F2, z, n);
     case 1:
-        return 2 * z / (z + 1);
+        return squared_barrier_factors<1>(F2, z, n);
     case 2:
-        return 13 * pow(z, l) / (z * (z + 3) + 9);
+        return squared_barrier_factors<2>(F2, z, n);
     case 3:
-        return 277 * pow(z, l) / (z * (z * (z + 6) + 45) + 225);
+        return squared_barrier_factors<3>(F2, z, n);
     case 4:
-        return 12746 * pow(z, l) / (z * (z * (z * (z + 10) + 135) + 1575) + 11025);
+        return squared_barrier_factors<4>(F2, z, n);
     case 5:
-        return 998881 * pow(z, l) / (z * (z * (z * (z * (z + 15) + 315) + 6300) + 99225) + 893025);
+        return squared_barrier_factors<5>(F2, z, n);
     case 6:
-        return 118394977 * pow(z, l) / (z * (z * (z * (z * (z * (z + 21) + 630) + 18900) + 496125) + 9823275) + 108056025);
+        return squared_barrier_factors<6>(F2, z, n);
     case 7:
-        return 19727003738LL * pow(z, l) / (z * (z * (z * (z * (z * (z * (z + 28) + 1134) + 47250) + 1819125) + 58939650) + 1404728325L) + 18261468225LL);
+        return squared_barrier_factors<7>(F2, z, n);
     default:
-        /// \todo: speed this up. And check how well it approximates.
-        // approximated:
-        double num = 0;
-        double den = 0;
-         for (int n = l; n >= 0; --n) {
-             double coef = exp(0.5 * l * n);
-             num += coef;
-             den += coef / pow(z, n);
-         }
-         return num / den;
+        for (size_t i = 0; i < n; ++i)
+            F2[i] = hankel_squared_barrier_factor(l, z[i]);
     }
 }
 
@@ -61,7 +121,8 @@ BlattWeisskopf::BlattWeisskopf(unsigned L, DecayingParticle* dp) :
 
     if (L_ > 0) {
         addParameter(DecayingParticle_->radialSize());
-        BarrierFactor_ = RealCachedValue::create(*this);
+        // barrier factors are O(1) and need no more than float precision
+        BarrierFactor_ = RealCachedValue::create(*this, StoragePrecision::single_precision);
     }
 
     // if L == 0, values are all always 1, no storage in DataPoint necessary
@@ -74,6 +135,12 @@ const std::complex<double> BlattWeisskopf::value(const DataPoint& d, const std::
     return (L_ == 0) ? 1 : BarrierFactor_->value(d, symmetrizationIndex(pc));
 }
 
+//-------------------------
+AmplitudeFactor BlattWeisskopf::factor(const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    return (L_ == 0) ? AmplitudeFactor(1.) : AmplitudeFactor(*BarrierFactor_, symmetrizationIndex(pc));
+}
+
 //-------------------------
 void BlattWeisskopf::calculate(DataPartition& D) const
 {
@@ -91,11 +158,23 @@ void BlattWeisskopf::calculate(DataPartition& D) const
 
             double r2 = pow(DecayingParticle_->radialSize()->value(), 2);
 
-            // calculate on all data points in D
-            for (auto& d : D) {
-                // measured breakup momentum
-                double q2_meas = measured_breakup_momenta::q2(d, pc_symIndex.first, *model());
-                BarrierFactor_->setValue(sqrt(squared_barrier_factor(L(), q2_meas * r2)), d, pc_symIndex.second, D);
+            std::array<double, block_size> z;
+            std::array<double, block_size> F2;
+
+            // calculate on all data points in D, block by block
+            for (auto first = D.begin(); first != D.end(); ) {
+
+                size_t n = std::min<size_t>(block_size, D.end() - first);
+
+                // measured breakup momentum * radial size
+                model()->measuredBreakupMomenta()->q2(first, n, pc_symIndex.first, z.data());
+                for (size_t i = 0; i < n; ++i)
+                    z[i] *= r2;
+
+                squared_barrier_factors(L(), F2.data(), z.data(), n);
+
+                for (size_t i = 0; i < n; ++i, ++first)
+                    BarrierFactor_->setValue(sqrt(F2[i]), *first, pc_symIndex.second, D);
             }
 
             // update status
@@ -107,7 +186,7 @@ void BlattWeisskopf::calculate(DataPartition& D) const
 //-------------------------
 void BlattWeisskopf::updateCalculationStatus(StatusManager& D) const
 {
-    if (status() == VariableStatus::changed)
+    if (BarrierFactor_)
         D.set(*BarrierFactor_, CalculationStatus::uncalculated);
 }
 
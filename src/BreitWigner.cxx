@@ -1,18 +1,17 @@
 #include "BreitWigner.h"
 
 #include "BlattWeisskopf.h"
-#include "CachedValue.h"
-#include "CalculationStatus.h"
 #include "DataPartition.h"
 #include "DecayChannel.h"
 #include "DecayingParticle.h"
-#include "FourMomenta.h"
 #include "logging.h"
 #include "MathUtilities.h"
 #include "MeasuredBreakupMomenta.h"
 #include "Model.h"
 #include "Parameter.h"
 
+#include <array>
+
 namespace yap {
 
 //-------------------------
@@ -45,12 +44,21 @@ void BreitWigner::checkDecayChannel(const DecayChannel& c) const
 }
 
 //-------------------------
-void BreitWigner::calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const
+RecalculableDataAccessorSet BreitWigner::dependencies() const
 {
-    // if no calculation necessary, exit
-    if (D.status(*T(), si) != CalculationStatus::uncalculated)
-        return;
+    return {BlattWeisskopf_.get()};
+}
 
+//-------------------------
+void BreitWigner::squaredBarrierFactors(double* F2, DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    for (size_t i = 0; i < n; ++i, ++first)
+        F2[i] = std::norm(BlattWeisskopf_->value(*first, pc));
+}
+
+//-------------------------
+void BreitWigner::calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const
+{
     /////////////////////////
     // common factors:
 
@@ -68,33 +76,36 @@ void BreitWigner::calculate(DataPartition& D, const std::shared_ptr<const Partic
 
     /////////////////////////
 
-    // calculate BlattWeisskopf
-    BlattWeisskopf_->calculate(D);
-
-    // T := 1 / (M^2 - m^2 - i * M * Gamma)
-    for (auto& d : D) {
+    // squared barrier factors
+    std::array<double, batch_size> F2;
+    squaredBarrierFactors(F2.data(), first, B.Size, pc);
 
-        // retrieve masses
-        double m_ab = model()->fourMomenta()->m(d, pc);
-        double m2_ab = m_ab * m_ab;
-        double m_a  = model()->fourMomenta()->m(d, pc->daughters()[0]);
-        double m_b  = model()->fourMomenta()->m(d, pc->daughters()[1]);
+    const auto& m_a = B.DaughterM[0];
+    const auto& m_b = B.DaughterM[1];
 
-        // calculate nominal breakup momentum
-        double q2_nomi = measured_breakup_momenta::q2(m2_R, m_a, m_b);
+    // measured breakup momenta
+    std::array<double, batch_size> q_meas;
+    model()->measuredBreakupMomenta()->q(first, B.Size, pc, q_meas.data());
 
-        // retrieve measured breakup momentum
-        double q2_meas = measured_breakup_momenta::q2(m2_ab, m_a, m_b);
+    // squared nominal breakup momenta and squared barrier factors at them
+    std::array<double, batch_size> q2_nomi;
+    std::array<double, batch_size> z_nomi;
+    for (size_t i = 0; i < B.Size; ++i) {
+        q2_nomi[i] = measured_breakup_momenta::q2(m2_R, m_a[i], m_b[i]);
+        z_nomi[i] = q2_nomi[i] * r2;
+    }
+    std::array<double, batch_size> F2_nomi;
+    squared_barrier_factors(BlattWeisskopf_->L(), F2_nomi.data(), z_nomi.data(), B.Size);
 
-        double Q = sqrt(q2_meas / q2_nomi);
+    // T := 1 / (M^2 - m^2 - i * M * Gamma)
+    for (size_t i = 0; i < B.Size; ++i) {
 
-        auto mw = m2w_R / m_ab * pow(Q, twoLp1) * pow(BlattWeisskopf_->value(d, pc), 2) / squared_barrier_factor(BlattWeisskopf_->L(), q2_nomi * r2);
+        double Q = q_meas[i] / sqrt(q2_nomi[i]);
 
-        T()->setValue(mw / (m2_R - m2_ab - 1_i * mw), d, si, D);
+        auto mw = m2w_R / B.M[i] * pow(Q, twoLp1) * F2[i] / F2_nomi[i];
 
+        B.T[i] = mw / (m2_R - B.M2[i] - 1_i * mw);
     }
-
-    D.status(*T(), si) = CalculationStatus::calculated;
 }
 
 }
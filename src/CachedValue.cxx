@@ -30,12 +30,17 @@ std::string to_string(const CachedValue::Status& S)
 }
 
 //-------------------------
-CachedValue::CachedValue(unsigned size, DataAccessor& da) :
+CachedValue::CachedValue(unsigned size, DataAccessor& da, StoragePrecision precision) :
     std::enable_shared_from_this<CachedValue>(),
     Owner_(&da),
     Index_(-1),
     Position_(-1),
-    Size_(size)
+    StatusOffset_(0),
+    Column_(0),
+    ColumnStride_(0),
+    Size_(size),
+    Precision_(precision),
+    Bound_(0)
 {
     if (Size_ == 0)
         throw exceptions::Exception("zero size", "CachedValue::CachedValue");
@@ -49,9 +54,9 @@ void CachedValue::addToDataAccessor()
 }
 
 //-------------------------
-std::shared_ptr<RealCachedValue> RealCachedValue::create(DataAccessor& da)
+std::shared_ptr<RealCachedValue> RealCachedValue::create(DataAccessor& da, StoragePrecision precision)
 {
-    auto c = std::shared_ptr<RealCachedValue>(new RealCachedValue(da));
+    auto c = std::shared_ptr<RealCachedValue>(new RealCachedValue(da, precision));
     c->addToDataAccessor();
     return c;
 }
@@ -59,18 +64,18 @@ std::shared_ptr<RealCachedValue> RealCachedValue::create(DataAccessor& da)
 //-------------------------
 void RealCachedValue::setValue(double val, DataPoint& d, unsigned sym_index, StatusManager& sm) const
 {
-    if (val != CachedValue::value(0, d, sym_index)) {
+    if (stored(val, d) != CachedValue::value(0, d, sym_index)) {
         CachedValue::setValue(0, val, d, sym_index);
-        sm.status(owner()->index(), index(), sym_index) = VariableStatus::changed;
+        sm.status(*this, sym_index) = VariableStatus::changed;
     }
 
-    sm.status(owner()->index(), index(), sym_index) = CalculationStatus::calculated;
+    sm.status(*this, sym_index) = CalculationStatus::calculated;
 }
 
 //-------------------------
-std::shared_ptr<ComplexCachedValue> ComplexCachedValue::create(DataAccessor& da)
+std::shared_ptr<ComplexCachedValue> ComplexCachedValue::create(DataAccessor& da, StoragePrecision precision)
 {
-    auto c = std::shared_ptr<ComplexCachedValue>(new ComplexCachedValue(da));
+    auto c = std::shared_ptr<ComplexCachedValue>(new ComplexCachedValue(da, precision));
     c->addToDataAccessor();
     return c;
 }
@@ -78,23 +83,23 @@ std::shared_ptr<ComplexCachedValue> ComplexCachedValue::create(DataAccessor& da)
 //-------------------------
 void ComplexCachedValue::setValue(double val_re, double val_im, DataPoint& d, unsigned sym_index, StatusManager& sm) const
 {
-    if (val_re != CachedValue::value(0, d, sym_index)) {
+    if (stored(val_re, d) != CachedValue::value(0, d, sym_index)) {
         CachedValue::setValue(0, val_re, d, sym_index);
-        sm.status(owner()->index(), index(), sym_index) = VariableStatus::changed;
+        sm.status(*this, sym_index) = VariableStatus::changed;
     }
 
-    if (val_im != CachedValue::value(1, d, sym_index)) {
+    if (stored(val_im, d) != CachedValue::value(1, d, sym_index)) {
         CachedValue::setValue(1, val_im, d, sym_index);
-        sm.status(owner()->index(), index(), sym_index) = VariableStatus::changed;
+        sm.status(*this, sym_index) = VariableStatus::changed;
     }
 
-    sm.status(owner()->index(), index(), sym_index) = CalculationStatus::calculated;
+    sm.status(*this, sym_index) = CalculationStatus::calculated;
 }
 
 //-------------------------
-std::shared_ptr<FourVectorCachedValue> FourVectorCachedValue::create(DataAccessor& da)
+std::shared_ptr<FourVectorCachedValue> FourVectorCachedValue::create(DataAccessor& da, StoragePrecision precision)
 {
-    auto c = std::shared_ptr<FourVectorCachedValue>(new FourVectorCachedValue(da));
+    auto c = std::shared_ptr<FourVectorCachedValue>(new FourVectorCachedValue(da, precision));
     c->addToDataAccessor();
     return c;
 }
@@ -120,12 +125,12 @@ void FourVectorCachedValue::setValue(const FourVector<double>& val, DataPoint& d
 void FourVectorCachedValue::setValue(const FourVector<double>& val, DataPoint& d, unsigned sym_index, StatusManager& sm) const
 {
     for (size_t i = 0; i < val.size(); ++i) {
-        if (val[i] != CachedValue::value(i, d, sym_index)) {
+        if (stored(val[i], d) != CachedValue::value(i, d, sym_index)) {
             CachedValue::setValue(i, val[i], d, sym_index);
-            sm.status(owner()->index(), index(), sym_index) = VariableStatus::changed;
+            sm.status(*this, sym_index) = VariableStatus::changed;
         }
     }
-    sm.status(owner()->index(), index(), sym_index) = CalculationStatus::calculated;
+    sm.status(*this, sym_index) = CalculationStatus::calculated;
 }
 
 }
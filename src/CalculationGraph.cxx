@@ -0,0 +1,138 @@
+#include "CalculationGraph.h"
+
+#include "DataPartition.h"
+#include "Exceptions.h"
+#include "RecalculableDataAccessor.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+
+namespace yap {
+
+//-------------------------
+CalculationGraph::CalculationGraph(const RecalculableDataAccessorSet& rdas)
+{
+    // collect dependencies, checking that they are all in the graph
+    std::map<RecalculableDataAccessor*, RecalculableDataAccessorSet> dependencies;
+    for (const auto& rda : rdas) {
+        auto& deps = dependencies[rda] = rda->dependencies();
+        if (std::any_of(deps.begin(), deps.end(), [&rdas](RecalculableDataAccessor* d) {return rdas.find(d) == rdas.end();}))
+            throw exceptions::Exception("dependency not registered with Model", "CalculationGraph::CalculationGraph");
+    }
+
+    // order topologically: repeatedly append all accessors whose dependencies are all placed
+    Order_.reserve(rdas.size());
+    RecalculableDataAccessorSet placed;
+    while (Order_.size() < rdas.size()) {
+        auto n = Order_.size();
+        for (const auto& rda : rdas)
+            if (placed.find(rda) == placed.end()
+                && std::includes(placed.begin(), placed.end(), dependencies[rda].begin(), dependencies[rda].end(), placed.key_comp())) {
+                Order_.push_back(rda);
+                placed.insert(rda);
+            }
+        if (Order_.size() == n)
+            throw exceptions::Exception("cyclic dependencies", "CalculationGraph::CalculationGraph");
+    }
+
+    // store edges by position in Order_
+    std::map<RecalculableDataAccessor*, unsigned> index;
+    for (unsigned i = 0; i < Order_.size(); ++i)
+        index[Order_[i]] = i;
+
+    Dependents_.assign(Order_.size(), {});
+    NDependencies_.assign(Order_.size(), 0);
+    for (unsigned i = 0; i < Order_.size(); ++i) {
+        for (const auto& d : dependencies[Order_[i]])
+            Dependents_[index[d]].push_back(i);
+        NDependencies_[i] = dependencies[Order_[i]].size();
+    }
+}
+
+//-------------------------
+unsigned CalculationGraph::depth() const
+{
+    // length of longest chain ending in each accessor
+    std::vector<unsigned> L(Order_.size(), 1);
+    for (unsigned i = 0; i < Order_.size(); ++i)
+        for (auto j : Dependents_[i])
+            L[j] = std::max(L[j], L[i] + 1);
+    return L.empty() ? 0 : *std::max_element(L.begin(), L.end());
+}
+
+//-------------------------
+void CalculationGraph::calculate(DataPartition& D, unsigned n_threads) const
+{
+    // if threading is unnecessary
+    if (n_threads <= 1 || Order_.size() <= 1) {
+        for (const auto& rda : Order_)
+            rda->calculate(D);
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    // number of uncalculated dependencies of each accessor
+    auto remaining = NDependencies_;
+
+    // accessors whose dependencies are all calculated
+    std::deque<unsigned> ready;
+    for (unsigned i = 0; i < remaining.size(); ++i)
+        if (remaining[i] == 0)
+            ready.push_back(i);
+
+    size_t finished = 0;
+    std::exception_ptr error;
+
+    // take ready accessors and calculate them, until all are finished or one has thrown
+    auto work = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [&]() {return !ready.empty() || finished == Order_.size() || error;});
+            if (finished == Order_.size() || error)
+                return;
+
+            auto i = ready.front();
+            ready.pop_front();
+
+            lock.unlock();
+            try {
+                Order_[i]->calculate(D);
+            } catch (...) {
+                lock.lock();
+                error = std::current_exception();
+                cv.notify_all();
+                return;
+            }
+            lock.lock();
+
+            ++finished;
+            for (auto j : Dependents_[i])
+                if (--remaining[j] == 0)
+                    ready.push_back(j);
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::future<void> > workers;
+    workers.reserve(n_threads - 1);
+    for (unsigned t = 1; t < std::min<size_t>(n_threads, Order_.size()); ++t)
+        workers.push_back(std::async(std::launch::async, work));
+
+    // calling thread works, too
+    work();
+
+    for (auto& w : workers)
+        w.get();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+}
@@ -5,10 +5,91 @@
 #include "Spin.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
 
 namespace yap {
 
+namespace ClebschGordan {
+
+namespace {
+
+// \return n!, from a table for all n whose factorial is representable as a double
+const double factorial(int n)
+{
+    static const std::array<double, 171> table = [] {
+        std::array<double, 171> t;
+        t[0] = 1;
+        for (size_t i = 1; i < t.size(); ++i)
+            t[i] = t[i - 1] * i;
+        return t;
+    }();
+    return (n < (int)table.size()) ? table[n] : std::tgamma(n + 1);
+}
+
+// \return Clebsch-Gordan coefficient calculated from Racah's formula,
+// for a coefficient already checked to be nonzero
+const double calculateCoefficient(unsigned two_j1, int two_m1, unsigned two_j2, int two_m2, unsigned two_J, int two_M)
+{
+    // z range dictated by factorials in denominator ( 1/n! = 0 when n < 0)
+    unsigned z_min = std::max<int>({0, (int)two_j2 - two_m1 - (int)two_J, (int)two_j1 + two_m2 - (int)two_J}) / 2;
+    unsigned z_max = std::min<int>({(int)two_j1 + (int)two_j2 - (int)two_J, (int)two_j1 - two_m1, (int)two_j2 + two_m2}) / 2;
+
+    double z_sum = 0;
+    for (unsigned z = z_min; z <= z_max; ++z) {
+        // z'th term := (-)^z / z! / (j1+j2-J-z)! / (j1-m1-z)! / (j2+m2-z)! / (J-j2+m1+z)! / (J-j1-m2+z)!
+        z_sum += (double)pow_negative_one(z)
+                 / factorial(z)
+                 / factorial(((int)two_j1 + (int)two_j2 - (int)two_J) / 2 - z)
+                 / factorial(((int)two_j1 - two_m1) / 2 - z)
+                 / factorial(((int)two_j2 + two_m2) / 2 - z)
+                 / factorial(((int)two_J - (int)two_j2 + two_m1) / 2 + z)
+                 / factorial(((int)two_J - (int)two_j1 - two_m2) / 2 + z);
+    }
+
+    // C-G coef = sqrt( (2J+1)! (j1+j2-J)! (j1-j2+J)! (j2-j1+J)! / (J+j1+j2+1)! )
+    //          * sqrt( (j1+m1)! (j1-m1)! (j2+m2)! (j2-m2)! (J+M)! (J-M)! )
+    //          * z_sum
+    return z_sum * sqrt((two_J + 1)
+                        * factorial(((int)two_j1 + (int)two_j2 - (int)two_J) / 2)
+                        * factorial(((int)two_j1 - (int)two_j2 + (int)two_J) / 2)
+                        * factorial(((int)two_j2 - (int)two_j1 + (int)two_J) / 2)
+                        / factorial(((int)two_j1 + (int)two_j2 + (int)two_J) / 2 + 1)
+                        * factorial(((int)two_j1 + two_m1) / 2)
+                        * factorial(((int)two_j1 - two_m1) / 2)
+                        * factorial(((int)two_j2 + two_m2) / 2)
+                        * factorial(((int)two_j2 - two_m2) / 2)
+                        * factorial(((int)two_J + two_M) / 2)
+                        * factorial(((int)two_J - two_M) / 2));
+}
+
+// maximum twice the spin for which coefficients are memoized
+constexpr unsigned max_two_j = 1023;
+
+// \return key for memoization of a coefficient; since M = m1 + m2,
+// it is determined by j1, m1, j2, m2, and J, each stored in 11 bits
+const uint64_t key(unsigned two_j1, int two_m1, unsigned two_j2, int two_m2, unsigned two_J)
+{
+    // projections are shifted to be nonnegative
+    return (uint64_t)two_j1
+           | (uint64_t)(two_m1 + (int)max_two_j) << 11
+           | (uint64_t)two_j2 << 22
+           | (uint64_t)(two_m2 + (int)max_two_j) << 33
+           | (uint64_t)two_J << 44;
+}
+
+// memoized nonzero coefficients
+std::unordered_map<uint64_t, double> Coefficients_;
+
+std::mutex CoefficientsMutex_;
+
+}
+
+}
+
 //-------------------------
 std::string ClebschGordan::to_string(unsigned two_j1, int two_m1, unsigned two_j2, int two_m2, unsigned two_J, int two_M)
 {
@@ -78,36 +159,17 @@ const double ClebschGordan::coefficient(unsigned two_j1, int two_m1, unsigned tw
     if (two_j1 == 0 or two_j2 == 0)
         return 1;
 
-    // z range dictated by factorials in denominator ( 1/n! = 0 when n < 0)
-    unsigned z_min = std::max<int>({0, (int)two_j2 - two_m1 - (int)two_J, (int)two_j1 + two_m2 - (int)two_J}) / 2;
-    unsigned z_max = std::min<int>({(int)two_j1 + (int)two_j2 - (int)two_J, (int)two_j1 - two_m1, (int)two_j2 + two_m2}) / 2;
+    // calculate directly for spins too large to memoize
+    if (std::max({two_j1, two_j2, two_J}) > max_two_j)
+        return calculateCoefficient(two_j1, two_m1, two_j2, two_m2, two_J, two_M);
 
-    double z_sum = 0;
-    for (unsigned z = z_min; z <= z_max; ++z) {
-        // z'th term := (-)^z / z! / (j1+j2-J-z)! / (j1-m1-z)! / (j2+m2-z)! / (J-j2+m1+z)! / (J-j1-m2+z)!
-        z_sum += (double)pow_negative_one(z)
-                 / std::tgamma(1 + z)
-                 / std::tgamma(1 + ((int)two_j1 + (int)two_j2 - (int)two_J) / 2 - z)
-                 / std::tgamma(1 + ((int)two_j1 - two_m1) / 2 - z)
-                 / std::tgamma(1 + ((int)two_j2 + two_m2) / 2 - z)
-                 / std::tgamma(1 + ((int)two_J - (int)two_j2 + two_m1) / 2 + z)
-                 / std::tgamma(1 + ((int)two_J - (int)two_j1 - two_m2) / 2 + z);
-    }
+    std::lock_guard<std::mutex> guard(CoefficientsMutex_);
 
-    // C-G coef = sqrt( (2J+1)! (j1+j2-J)! (j1-j2+J)! (j2-j1+J)! / (J+j1+j2+1)! )
-    //          * sqrt( (j1+m1)! (j1-m1)! (j2+m2)! (j2-m2)! (J+M)! (J-M)! )
-    //          * z_sum
-    return z_sum * sqrt((two_J + 1)
-                        * std::tgamma(1 + ((int)two_j1 + (int)two_j2 - (int)two_J) / 2)
-                        * std::tgamma(1 + ((int)two_j1 - (int)two_j2 + (int)two_J) / 2)
-                        * std::tgamma(1 + ((int)two_j2 - (int)two_j1 + (int)two_J) / 2)
-                        / std::tgamma(1 + ((int)two_j1 + (int)two_j2 + (int)two_J) / 2 + 1)
-                        * std::tgamma(1 + ((int)two_j1 + two_m1) / 2)
-                        * std::tgamma(1 + ((int)two_j1 - two_m1) / 2)
-                        * std::tgamma(1 + ((int)two_j2 + two_m2) / 2)
-                        * std::tgamma(1 + ((int)two_j2 - two_m2) / 2)
-                        * std::tgamma(1 + ((int)two_J + two_M) / 2)
-                        * std::tgamma(1 + ((int)two_J - two_M) / 2));
+    auto k = key(two_j1, two_m1, two_j2, two_m2, two_J);
+    auto it = Coefficients_.find(k);
+    if (it == Coefficients_.end())
+        it = Coefficients_.emplace(k, calculateCoefficient(two_j1, two_m1, two_j2, two_m2, two_J, two_M)).first;
+    return it->second;
 }
 
 //-------------------------
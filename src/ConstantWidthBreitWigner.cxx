@@ -1,11 +1,8 @@
 #include "ConstantWidthBreitWigner.h"
 
-#include "CachedValue.h"
-#include "CalculationStatus.h"
 #include "DataPartition.h"
-#include "FourMomenta.h"
 #include "logging.h"
-#include "Model.h"
+#include "MathUtilities.h"
 #include "Parameter.h"
 #include "ParticleTable.h"
 
@@ -14,7 +11,6 @@ namespace yap {
 //-------------------------
 ConstantWidthBreitWigner::ConstantWidthBreitWigner(double m, double w) :
     MassShapeWithNominalMass(m),
-    T_(ComplexCachedValue::create(*this)),
     Width_(std::make_shared<PositiveRealParameter>(w))
 {
     addParameter(Width_);
@@ -27,25 +23,8 @@ ConstantWidthBreitWigner::ConstantWidthBreitWigner(const ParticleTableEntry& pde
 }
 
 //-------------------------
-void ConstantWidthBreitWigner::updateCalculationStatus(StatusManager& D) const
+void ConstantWidthBreitWigner::calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const
 {
-    if (status() == VariableStatus::changed)
-        D.set(*T_, CalculationStatus::uncalculated);
-}
-
-//-------------------------
-const std::complex<double> ConstantWidthBreitWigner::value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
-{
-    return T_->value(d, symmetrizationIndex(pc));
-}
-
-//-------------------------
-void ConstantWidthBreitWigner::calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const
-{
-    // if no calculation necessary, exit
-    if (D.status(*T_, si) != CalculationStatus::uncalculated)
-        return;
-
     /////////////////////////
     // common factors:
     
@@ -58,10 +37,8 @@ void ConstantWidthBreitWigner::calculate(DataPartition& D, const std::shared_ptr
     /////////////////////////
     
     // T := mass * width / (mass^2 - s - i * mass * width)
-    for (auto& d : D)
-        T_->setValue(mw / (m2_imw - model()->fourMomenta()->m2(d, pc)), d, si, D);
-
-    D.status(*T_, si) = CalculationStatus::calculated;
+    for (size_t i = 0; i < B.Size; ++i)
+        B.T[i] = mw / (m2_imw - B.M2[i]);
 }
 
 }
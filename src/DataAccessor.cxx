@@ -12,10 +12,37 @@ DataAccessor::DataAccessor(const ParticleCombinationEqualTo& equal) :
     Equal_(equal),
     NIndices_(0),
     Size_(0),
-    Index_(-1)
+    Index_(-1),
+    StatusOffset_(0),
+    ColumnOffset_(0)
 {
 }
 
+//-------------------------
+void DataAccessor::setStatusOffset(unsigned o)
+{
+    StatusOffset_ = o;
+    for (auto& c : CachedValues_)
+        c->setStatusOffset(StatusOffset_ + c->index() * NIndices_);
+}
+
+//-------------------------
+void DataAccessor::setColumnOffset(unsigned o)
+{
+    ColumnOffset_ = o;
+    for (auto& c : CachedValues_)
+        c->setColumns(ColumnOffset_ + c->position(), Size_);
+}
+
+//-------------------------
+void DataAccessor::tabulateSymmetrizationIndices(unsigned n)
+{
+    SymmetrizationIndexTable_.assign(n, -1);
+    for (const auto& kv : SymmetrizationIndices_)
+        if (kv.first->index() >= 0 and kv.first->index() < (int)n)
+            SymmetrizationIndexTable_[kv.first->index()] = kv.second;
+}
+
 //-------------------------
 bool DataAccessor::consistent() const
 {
@@ -0,0 +1,210 @@
+#include "DataColumns.h"
+
+#include "CachedValue.h"
+#include "DataAccessor.h"
+#include "Exceptions.h"
+#include "StoragePrecision.h"
+
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+namespace yap {
+
+namespace {
+
+/// number of rows capacity is rounded to, to keep every column
+/// aligned even behind columns of the narrowest elements
+constexpr size_t row_alignment = AlignedAllocator<unsigned char>::alignment / sizeof(int16_t);
+
+/// \return n rounded up to multiple of row_alignment
+constexpr size_t aligned_capacity(size_t n)
+{ return (n + row_alignment - 1) / row_alignment * row_alignment; }
+
+}
+
+//-------------------------
+DataColumns::DataColumns(const DataAccessorSet& sDA, StoragePrecision precision, std::shared_ptr<MemoryArena> arena) :
+    Precision_(precision),
+    Offsets_(sDA.size() + 1, 0),
+    Size_(0),
+    Capacity_(0),
+    Data_(AlignedAllocator<unsigned char>(arena))
+{
+    for (auto da : sDA)
+        Offsets_[da->index() + 1] = da->nSymmetrizationIndices() * da->size();
+    std::partial_sum(Offsets_.begin(), Offsets_.end(), Offsets_.begin());
+
+    // element size of each column, from precision of CachedValue it belongs to,
+    // lowered to precision of this
+    ByteOffsets_.assign(nColumns() + 1, 0);
+    for (auto da : sDA)
+        for (const auto& c : da->CachedValues())
+            for (unsigned s = 0; s < da->nSymmetrizationIndices(); ++s)
+                for (unsigned k = 0; k < c->size(); ++k)
+                    ByteOffsets_[Offsets_[da->index()] + s * da->size() + c->position() + k + 1] = bytes_per_element(c->storagePrecision(Precision_));
+    std::partial_sum(ByteOffsets_.begin(), ByteOffsets_.end(), ByteOffsets_.begin());
+
+    Columns_.assign(nColumns(), nullptr);
+}
+
+//-------------------------
+DataColumns::DataColumns(const DataColumns& other) :
+    Precision_(other.Precision_),
+    Offsets_(other.Offsets_),
+    ByteOffsets_(other.ByteOffsets_),
+    Size_(other.Size_),
+    Capacity_(other.Capacity_),
+    Data_(other.Data_),
+    Columns_(other.Columns_),
+    Mapped_(other.Mapped_),
+    Mapping_(other.Mapping_)
+{
+    // point own columns into copied buffer
+    for (unsigned j = 0; j < nColumns(); ++j)
+        if (Mapped_.empty() or !Mapped_[j])
+            Columns_[j] = Data_.data() + (other.Columns_[j] - other.Data_.data());
+
+    // copies don't share mapped columns
+    materialize();
+}
+
+//-------------------------
+void DataColumns::reallocate(size_t c)
+{
+    c = aligned_capacity(c);
+
+    if (c == Capacity_ and !mapped())
+        return;
+
+    // with no rows to keep, release old storage first, so that an arena can reuse it
+    if (Size_ == 0)
+        std::vector<unsigned char, AlignedAllocator<unsigned char> >(Data_.get_allocator()).swap(Data_);
+
+    std::vector<unsigned char, AlignedAllocator<unsigned char> > data(rowBytes() * c, 0, Data_.get_allocator());
+    std::vector<unsigned char*> columns(nColumns());
+    for (unsigned j = 0; j < nColumns(); ++j) {
+        columns[j] = data.data() + ByteOffsets_[j] * c;
+        if (Size_ > 0)
+            std::memcpy(columns[j], columnBytes(j), width(j) * Size_);
+    }
+
+    Data_.swap(data);
+    Columns_.swap(columns);
+    Capacity_ = c;
+
+    Mapped_.clear();
+    Mapping_.reset();
+}
+
+//-------------------------
+void DataColumns::reserve(size_t n)
+{
+    if (n > Capacity_)
+        reallocate(n);
+}
+
+//-------------------------
+void DataColumns::resize(size_t n)
+{
+    // mapped columns hold no rows beyond Size_
+    if (n > Capacity_ or (n > Size_ and mapped()))
+        reallocate(std::max(n, 2 * Capacity_));
+
+    // zero new rows, which may hold values from erased rows
+    if (n > Size_)
+        for (unsigned j = 0; j < nColumns(); ++j)
+            std::memset(columnBytes(j) + width(j) * Size_, 0, width(j) * (n - Size_));
+
+    Size_ = n;
+}
+
+//-------------------------
+void DataColumns::shrink_to_fit()
+{
+    // don't copy mapped columns into the buffer
+    if (mapped())
+        return;
+    reallocate(Size_);
+    Data_.shrink_to_fit();
+}
+
+//-------------------------
+void DataColumns::map(size_t n, const std::vector<const void*>& columns, std::shared_ptr<const void> mapping)
+{
+    if (columns.size() != nColumns())
+        throw exceptions::Exception("wrong number of columns", "DataColumns::map");
+
+    size_t c = aligned_capacity(n);
+
+    // buffer offsets of columns not mapped
+    std::vector<size_t> offsets(nColumns() + 1, 0);
+    for (unsigned j = 0; j < nColumns(); ++j)
+        offsets[j + 1] = offsets[j] + (columns[j] ? 0 : width(j));
+
+    // reuse buffer if it has the right size, as when mapping chunks of equal size one after the other
+    if (Data_.size() == offsets.back() * c)
+        std::memset(Data_.data(), 0, Data_.size());
+    else {
+        std::vector<unsigned char, AlignedAllocator<unsigned char> >(Data_.get_allocator()).swap(Data_);
+        Data_.assign(offsets.back() * c, 0);
+    }
+
+    // mapped columns are never written through (see #materialize)
+    Mapped_.assign(nColumns(), false);
+    for (unsigned j = 0; j < nColumns(); ++j) {
+        Mapped_[j] = columns[j] != nullptr;
+        Columns_[j] = Mapped_[j] ? static_cast<unsigned char*>(const_cast<void*>(columns[j])) : Data_.data() + offsets[j] * c;
+    }
+
+    Mapping_ = mapping;
+    Size_ = n;
+    Capacity_ = c;
+}
+
+//-------------------------
+void DataColumns::insert(size_t pos, size_t n)
+{
+    materialize();
+    auto N = Size_;
+    resize(Size_ + n);
+    for (unsigned j = 0; j < nColumns(); ++j) {
+        auto col = columnBytes(j);
+        auto w = width(j);
+        std::memmove(col + (pos + n) * w, col + pos * w, (N - pos) * w);
+        std::memset(col + pos * w, 0, n * w);
+    }
+}
+
+//-------------------------
+void DataColumns::erase(size_t first, size_t last)
+{
+    materialize();
+    for (unsigned j = 0; j < nColumns(); ++j) {
+        auto col = columnBytes(j);
+        auto w = width(j);
+        std::memmove(col + first * w, col + last * w, (Size_ - last) * w);
+    }
+    Size_ -= last - first;
+}
+
+//-------------------------
+void DataColumns::copy(size_t row, const DataColumns& src, size_t src_row)
+{
+    materialize();
+    for (unsigned j = 0; j < nColumns(); ++j)
+        std::memcpy(columnBytes(j) + width(j) * row, src.columnBytes(j) + width(j) * src_row, width(j));
+}
+
+//-------------------------
+bool equalRows(const DataColumns& A, size_t a, const DataColumns& B, size_t b)
+{
+    if (!equalStructure(A, B))
+        return false;
+    for (unsigned j = 0; j < A.nColumns(); ++j)
+        if (std::memcmp(A.columnBytes(j) + A.width(j) * a, B.columnBytes(j) + B.width(j) * b, A.width(j)) != 0)
+            return false;
+    return true;
+}
+
+}
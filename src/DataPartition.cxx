@@ -17,19 +17,29 @@ const DataIterator::difference_type operator-(const DataIterator& lhs, const Dat
 {
     if (lhs.Partition_ != rhs.Partition_)
         throw exceptions::Exception("DataIterator's belong to different DataPartition's", "operator-");
-    return lhs.Partition_->difference(lhs.Iterator_, rhs.Iterator_);
+    return lhs.Partition_->difference(lhs.Point_.row(), rhs.Point_.row());
 }
 
 //-------------------------
-DataPointVector::iterator DataPartition::begin(DataSet& ds)
+DataPoint DataPartition::row(DataSet& ds, size_t r)
 {
-    return ds.dataPoints().begin();
+    return DataPoint(ds.columns(), r);
 }
 
 //-------------------------
-DataPointVector::iterator DataPartition::end(DataSet& ds)
+DataPartitionWeave::DataPartitionWeave(const StatusManager& sm, const DataPoint& begin, const DataPoint& end, unsigned spacing) :
+    DataPartition(sm, begin, end),
+    Spacing_(spacing)
 {
-    return ds.dataPoints().end();
+    if (Spacing_ == 0)
+        throw exceptions::Exception("spacing is zero", "DataPartitionWeave::DataPartitionWeave");
+
+    // round number of points up, so that end is reached from begin
+    auto b = rawIterator(DataPartition::begin());
+    auto e = DataPartition::end();
+    auto& r = rawIterator(e);
+    r = (r > b) ? b + (r - b + Spacing_ - 1) / Spacing_ * Spacing_ : b;
+    setEnd(*e);
 }
 
 //-------------------------
@@ -40,9 +50,9 @@ DataIterator& DataPartitionWeave::increment(DataIterator& it, DataIterator::diff
 }
 
 //-------------------------
-const DataIterator::difference_type DataPartition::difference(const DataPointVector::iterator& lhs, const DataPointVector::iterator& rhs) const
+const DataIterator::difference_type DataPartition::difference(size_t lhs, size_t rhs) const
 {
-    return static_cast<DataIterator::difference_type>(lhs - rhs);
+    return static_cast<DataIterator::difference_type>(lhs) - static_cast<DataIterator::difference_type>(rhs);
 }
 
 
@@ -56,7 +66,7 @@ DataPartitionVector DataPartitionWeave::create(DataSet& dataSet, unsigned n)
     P.reserve(n);
 
     for (unsigned i = 0; i < n; ++i)
-        P.push_back(new DataPartitionWeave(dataSet, begin(dataSet) + i, end(dataSet), n));
+        P.push_back(new DataPartitionWeave(dataSet, row(dataSet, i), row(dataSet, dataSet.size()), n));
 
     return P;
 }
@@ -75,14 +85,14 @@ DataPartitionVector DataPartitionBlock::create(DataSet& dataSet, unsigned n)
     DataPartitionVector P;
     P.reserve(n);
 
-    auto it_b = begin(dataSet);
+    size_t r_b = 0;
 
     for (unsigned i = 0; i < n - 1; ++i) {
-        auto it_e = it_b + p_size;
-        P.push_back(new DataPartitionBlock(dataSet, it_b, it_e));
-        it_b = it_e;
+        auto r_e = r_b + p_size;
+        P.push_back(new DataPartitionBlock(dataSet, row(dataSet, r_b), row(dataSet, r_e)));
+        r_b = r_e;
     }
-    P.push_back(new DataPartitionBlock(dataSet, it_b, end(dataSet)));
+    P.push_back(new DataPartitionBlock(dataSet, row(dataSet, r_b), row(dataSet, N)));
 
     return P;
 }
@@ -99,11 +109,11 @@ DataPartitionVector DataPartitionBlock::createBySize(DataSet& dataSet, size_t s)
     DataPartitionVector P;
     P.reserve(std::ceil(N / s));
 
-    auto it_b = begin(dataSet);
-    while (it_b != end(dataSet)) {
-        auto it_e = it_b + s;
-        P.push_back(new DataPartitionBlock(dataSet, it_b, it_e));
-        it_b = it_e;
+    size_t r_b = 0;
+    while (r_b != N) {
+        auto r_e = std::min(r_b + s, N);
+        P.push_back(new DataPartitionBlock(dataSet, row(dataSet, r_b), row(dataSet, r_e)));
+        r_b = r_e;
     }
 
     return P;
@@ -5,35 +5,18 @@
 namespace yap {
 
 //-------------------------
-DataPoint::DataPoint(const DataAccessorSet& dataAccessorSet)
-    : Data_(dataAccessorSet.size())
+DataPoint::DataPoint(const DataAccessorSet& dataAccessorSet, StoragePrecision precision) :
+    Storage_(std::make_shared<DataColumns>(dataAccessorSet, precision)),
+    Columns_(Storage_.get()),
+    Row_(0)
 {
-    for (auto da : dataAccessorSet)
-        Data_[da->index()].assign(da->nSymmetrizationIndices() * da->size(), 0.);
-}
-
-//-------------------------
-bool equalStructure(const DataPoint& A, const DataPoint& B)
-{
-    if (A.Data_.size() != B.Data_.size())
-        return false;
-    for (size_t i = 0; i < A.Data_.size(); ++i) {
-        if (A.Data_[i].size() != B.Data_[i].size())
-            return false;
-    }
-    return true;
+    Storage_->resize(1);
 }
 
 //-------------------------
 unsigned DataPoint::bytes() const
 {
-    unsigned size = sizeof(Data_);
-    for (auto& v : Data_) {
-        size += sizeof(v);
-        for (auto& vv : v)
-            size += sizeof(vv);
-    }
-    return size;
+    return Columns_->rowBytes();
 }
 
 }
@@ -1,22 +1,76 @@
 #include "DataSet.h"
 
+#include "CachedValue.h"
+#include "CalculationStatus.h"
 #include "DataPoint.h"
 #include "Exceptions.h"
 #include "Model.h"
+#include "StaticDataAccessor.h"
+#include "StaticDataCache.h"
+
+#include <algorithm>
+#include <stdexcept>
 
 namespace yap {
 
 //-------------------------
-DataSet::DataSet(const Model& m) :
-    DataPartitionBlock(m.dataAccessors()),
+DataSet::DataSet(const Model& m, StoragePrecision precision, std::shared_ptr<MemoryArena> arena) :
+    DataPartitionBlock(m.dataAccessors(), arena),
+    Columns_(m.dataAccessors(), precision, arena),
     Model_(&m)
 {
+    setIterators();
+}
+
+//-------------------------
+DataSet::DataSet(const DataSet& other) :
+    DataPartitionBlock(other),
+    Columns_(other.Columns_),
+    Model_(other.Model_)
+{
+    setIterators();
+}
+
+//-------------------------
+DataSet::DataSet(DataSet&& other) :
+    DataPartitionBlock(std::move(other)),
+    Columns_(std::move(other.Columns_)),
+    Model_(other.Model_)
+{
+    setIterators();
+}
+
+//-------------------------
+DataSet& DataSet::operator=(const DataSet& other)
+{
+    DataPartitionBlock::operator=(other);
+    Columns_ = other.Columns_;
+    Model_ = other.Model_;
+    setIterators();
+    return *this;
+}
+
+//-------------------------
+DataSet& DataSet::operator=(DataSet&& other)
+{
+    DataPartitionBlock::operator=(std::move(other));
+    Columns_ = std::move(other.Columns_);
+    Model_ = other.Model_;
+    setIterators();
+    return *this;
+}
+
+//-------------------------
+void DataSet::setIterators()
+{
+    setBegin(DataPoint(Columns_, 0));
+    setEnd(DataPoint(Columns_, Columns_.size()));
 }
 
 //-------------------------
 bool DataSet::consistent(const DataPoint& d) const
 {
-    return DataPoints_.empty() or equalStructure(DataPoints_.front(), d);
+    return equalStructure(Columns_, *d.Columns_);
 }
 
 //-------------------------
@@ -28,52 +82,114 @@ void DataSet::addEmptyDataPoints(size_t n)
     if (!model())
         throw exceptions::Exception("Model unset or deleted", "DataSet::addEmptyDataPoints");
 
-    // create first data point, either via DataAccessorSet constructor or copy constructor
-    DataPoints_.emplace_back(DataPoints_.empty() ? model()->dataAccessors() : DataPoints_.back());
-
-    // create remaining data points via copy constructor
-    for (size_t i = 1; i < n; ++i)
-        DataPoints_.emplace_back(DataPoints_.back());
+    Columns_.resize(Columns_.size() + n);
+    setIterators();
 }
 
 //-------------------------
 const DataPoint DataSet::createDataPoint(const std::vector<FourVector<double> >& P, StatusManager& sm)
 {
-    DataPoint d = DataPoints_.empty() ? DataPoint(model()->dataAccessors()) : DataPoints_.back();
+    DataPoint d(model()->dataAccessors(), precision());
     model()->setFinalStateMomenta(d, P, sm);
     return d;
 }
 
+//-------------------------
+void DataSet::map(std::shared_ptr<StaticDataCache> cache)
+{
+    if (!cache)
+        throw exceptions::Exception("StaticDataCache is empty", "DataSet::map");
+
+    map(cache, 0, cache->size());
+}
+
+//-------------------------
+void DataSet::map(std::shared_ptr<StaticDataCache> cache, size_t first, size_t last)
+{
+    if (!cache)
+        throw exceptions::Exception("StaticDataCache is empty", "DataSet::map");
+
+    if (first > last or last > cache->size())
+        throw exceptions::Exception("range of data points out of bounds", "DataSet::map");
+
+    if (!model())
+        throw exceptions::Exception("Model unset or deleted", "DataSet::map");
+
+    if (cache->key() != static_data_key(*model(), precision()))
+        throw exceptions::Exception("StaticDataCache was written for a different model or precision", "DataSet::map");
+
+    auto sc = static_columns(*model());
+    if (sc.size() != cache->nColumns())
+        throw exceptions::Exception("StaticDataCache has wrong number of columns", "DataSet::map");
+
+    std::vector<const void*> columns(Columns_.nColumns(), nullptr);
+    for (size_t k = 0; k < sc.size(); ++k) {
+        auto j = Columns_.offset(sc[k].first) + sc[k].second;
+        if (cache->width(k) != Columns_.width(j))
+            throw exceptions::Exception("StaticDataCache has wrong column width", "DataSet::map");
+        columns[j] = static_cast<const char*>(cache->column(k)) + first * cache->width(k);
+    }
+
+    Columns_.map(last - first, columns, cache);
+    setIterators();
+
+    // values of all other data accessors must be calculated anew
+    setAll(CalculationStatus::uncalculated);
+    for (const auto& da : model()->dataAccessors())
+        if (dynamic_cast<const StaticDataAccessor*>(da))
+            set(*da, CalculationStatus::calculated);
+}
+
+//-------------------------
+void DataSet::push_back(const std::vector<FourVector<double> >& P)
+{
+    insert(end(), P);
+}
+
 //-------------------------
 void DataSet::push_back(const DataPoint& d)
 {
-    if (!consistent(d))
-        throw exceptions::InconsistentDataPoint("DataSet::push_back");
-    DataPoints_.push_back(d);
+    insert(end(), d);
 }
 
 //-------------------------
-void DataSet::push_back(DataPoint&& d)
+DataIterator DataSet::insert(const DataIterator& pos, const std::vector<FourVector<double> >& P)
 {
-    if (!consistent(d))
-        throw exceptions::InconsistentDataPoint("DataSet::push_back");
-    DataPoints_.push_back(std::move(d));
+    auto r = rawIterator(pos);
+    Columns_.insert(r);
+    setIterators();
+    DataPoint d(Columns_, r);
+    try {
+        model()->setFinalStateMomenta(d, P, *this);
+    } catch (...) {
+        Columns_.erase(r, r + 1);
+        setIterators();
+        throw;
+    }
+    return dataIterator(d, pos.partition());
 }
 
 //-------------------------
 DataIterator DataSet::insert(const DataIterator& pos, const DataPoint& d)
 {
     if (!consistent(d))
-        throw exceptions::InconsistentDataPoint("DataSet::push_back");
-    return dataIterator(DataPoints_.insert(rawIterator(pos), d), pos.partition());
+        throw exceptions::InconsistentDataPoint("DataSet::insert");
+    auto r = rawIterator(pos);
+    // row of d is shifted if it is in this data set behind insertion point
+    auto r_d = (d.Columns_ == &Columns_ and d.Row_ >= r) ? d.Row_ + 1 : d.Row_;
+    Columns_.insert(r);
+    Columns_.copy(r, *d.Columns_, r_d);
+    setIterators();
+    return dataIterator(DataPoint(Columns_, r), pos.partition());
 }
 
 //-------------------------
-DataIterator DataSet::insert(const DataIterator& pos, DataPoint&& d)
+DataIterator DataSet::erase(const DataIterator& pos)
 {
-    if (!consistent(d))
-        throw exceptions::InconsistentDataPoint("DataSet::push_back");
-    return dataIterator(DataPoints_.insert(rawIterator(pos), std::move(d)), pos.partition());
+    auto r = rawIterator(pos);
+    Columns_.erase(r, r + 1);
+    setIterators();
+    return dataIterator(DataPoint(Columns_, r), pos.partition());
 }
 
 //-------------------------
@@ -81,18 +197,43 @@ DataIterator DataSet::erase(const DataIterator& first, const DataIterator& last)
 {
     if (first.partition() != last.partition())
         throw exceptions::Exception("Iterators' partitions don't match", "DataSet::erase");
-    if (first.partition() == this)
-        return dataIterator(DataPoints_.erase(rawIterator(first), rawIterator(last)), first.partition());
+    if (first.partition() == this) {
+        auto r_first = rawIterator(first);
+        Columns_.erase(r_first, rawIterator(last));
+        setIterators();
+        return dataIterator(DataPoint(Columns_, r_first), first.partition());
+    }
     auto it = first;
     while (it != last)
         erase(it++);
     return last;
 }
 
+//-------------------------
+DataPoint DataSet::at(size_t i)
+{
+    if (i >= size())
+        throw std::out_of_range("DataSet::at");
+    return DataPoint(Columns_, i);
+}
+
+//-------------------------
+const double DataSet::quantizationError() const
+{
+    if (!model())
+        throw exceptions::Exception("Model unset or deleted", "DataSet::quantizationError");
+
+    double e = 0;
+    for (const auto& da : model()->dataAccessors())
+        for (const auto& c : da->CachedValues())
+            e = std::max(e, c->quantizationError(precision()));
+    return e;
+}
+
 //-------------------------
 const unsigned DataSet::bytes() const
 {
-    return empty() ? 0 : size() * front().bytes();
+    return Columns_.bytes();
 }
 
 }
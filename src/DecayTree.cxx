@@ -9,6 +9,7 @@
 #include "Model.h"
 #include "Particle.h"
 #include "ParticleCombination.h"
+#include "Spin.h"
 #include "SpinAmplitude.h"
 #include "VariableStatus.h"
 
@@ -31,6 +32,12 @@ DecayTree::DecayTree(std::shared_ptr<FreeAmplitude> free_amp, int two_M, const S
 
     if (!FreeAmplitude_->decayChannel())
         throw exceptions::Exception("FreeAmplitude's DecayChannel is nullptr", "DecayTree::DecayTree");
+
+    if (FreeAmplitude_->spinAmplitude()->twoM(InitialTwoM_).count(FinalTwoM_) == 0)
+        throw exceptions::Exception("SpinAmplitude has no amplitude for " + spin_to_string(InitialTwoM_) + " -> " + to_string(FinalTwoM_),
+                                    "DecayTree::DecayTree");
+
+    AmplitudeIndex_ = FreeAmplitude_->spinAmplitude()->amplitudeIndex(InitialTwoM_, FinalTwoM_);
 }
 
 //-------------------------
@@ -84,7 +91,7 @@ const std::complex<double> DecayTree::dataDependentAmplitude(const DataPoint& d)
 const std::complex<double> DecayTree::dataDependentAmplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
 {
     // spin amplitude
-    auto A = FreeAmplitude_->spinAmplitude()->amplitude(d, pc, InitialTwoM_, FinalTwoM_);
+    auto A = FreeAmplitude_->spinAmplitude()->amplitude(d, pc, AmplitudeIndex_);
 
     // amplitude components
     for (const auto& ac : AmplitudeComponents_)
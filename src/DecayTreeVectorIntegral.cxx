@@ -1,15 +1,35 @@
 #include "DecayTreeVectorIntegral.h"
 
+#include "AmplitudeComponent.h"
 #include "DecayTree.h"
 #include "Exceptions.h"
 #include "IntegralElement.h"
+#include "RecalculableDataAccessor.h"
 
 #include <algorithm>
 #include <complex>
 #include <numeric>
+#include <set>
 
 namespace yap {
 
+namespace {
+
+//-------------------------
+// insert recalculable amplitude components of a DecayTree and its daughters into S
+void insert_recalculable_data_accessors(const DecayTree& dt, std::set<const RecalculableDataAccessor*>& S)
+{
+    for (const auto& ac : dt.amplitudeComponents()) {
+        auto rda = dynamic_cast<const RecalculableDataAccessor*>(ac);
+        if (rda)
+            S.insert(rda);
+    }
+    for (const auto& d_dt : dt.daughterDecayTrees())
+        insert_recalculable_data_accessors(*d_dt.second, S);
+}
+
+}
+
 //-------------------------
 DecayTreeVectorIntegral::DecayTreeVectorIntegral(const DecayTreeVector& dtv)
     : DecayTrees_(dtv),
@@ -18,6 +38,23 @@ DecayTreeVectorIntegral::DecayTreeVectorIntegral(const DecayTreeVector& dtv)
 {
     for (size_t i = 0; i < OffDiagonals_.size(); ++i)
         OffDiagonals_[i] = ComplexIntegralElementMatrix::value_type(DecayTrees_.size() - i - 1);
+
+    // collect (once) all accessors whose parameters the integral depends on
+    std::set<const RecalculableDataAccessor*> S;
+    for (const auto& dt : DecayTrees_)
+        if (dt)
+            insert_recalculable_data_accessors(*dt, S);
+    RecalculableDataAccessors_.assign(S.begin(), S.end());
+
+    // start out of date
+    Generation_ = generation() - 1;
+}
+
+//-------------------------
+unsigned DecayTreeVectorIntegral::generation() const
+{
+    return std::accumulate(RecalculableDataAccessors_.begin(), RecalculableDataAccessors_.end(), 0u,
+                           [](unsigned g, const RecalculableDataAccessor* rda) {return g + rda->generation();});
 }
 
 //-------------------------
@@ -89,6 +126,7 @@ DecayTreeVectorIntegral& DecayTreeVectorIntegral::reset()
     for (auto& row : OffDiagonals_)
         for (auto& elt : row)
             elt.reset();
+    Generation_ = generation();
     return *this;
 }
 
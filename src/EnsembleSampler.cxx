@@ -0,0 +1,459 @@
+#include "EnsembleSampler.h"
+
+#include "AmplitudePlan.h"
+#include "CompensatedSum.h"
+#include "DataPartition.h"
+#include "DecayTreeVectorIntegral.h"
+#include "Exceptions.h"
+#include "FreeAmplitude.h"
+#include "IntegralElement.h"
+#include "Model.h"
+#include "ModelIntegral.h"
+#include "Parameter.h"
+#include "VariableStatus.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+
+namespace yap {
+
+namespace {
+
+/// identifies file as chain file
+constexpr char magic[8] = {'Y', 'A', 'P', 'M', 'C', 'M', 'C', 0};
+
+/// version of file format
+constexpr uint32_t version = 1;
+
+/// header of chain file
+struct Header {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t NParameters;
+    uint64_t NWalkers;
+};
+
+/// number of data points per block of the pass over the data,
+/// small enough for the block's amplitudes to stay in cache for all walkers
+constexpr size_t block_size = 256;
+
+}
+
+//-------------------------
+EnsembleSampler::EnsembleSampler(const Model& M, DataPartitionVector fit_partitions, const ModelIntegral& MI,
+                                 unsigned n_walkers, unsigned seed) :
+    Model_(&M),
+    FitPartitions_(fit_partitions),
+    Integral_(&MI),
+    NDataPoints_(0),
+    NWalkers_(n_walkers),
+    StretchScale_(2.),
+    Generator_(seed),
+    Proposals_(0),
+    Accepted_(0),
+    Task_(nullptr),
+    TaskGeneration_(0),
+    Pending_(0),
+    Stop_(false)
+{
+    if (!Model_->locked())
+        throw exceptions::Exception("Model is not locked", "EnsembleSampler::EnsembleSampler");
+
+    if (FitPartitions_.empty())
+        throw exceptions::Exception("DataPartitionVector is empty", "EnsembleSampler::EnsembleSampler");
+
+    if (std::any_of(FitPartitions_.begin(), FitPartitions_.end(), std::logical_not<DataPartitionVector::value_type>()))
+        throw exceptions::Exception("DataPartitionVector contains nullptr", "EnsembleSampler::EnsembleSampler");
+
+    if (NWalkers_ < 2 or NWalkers_ % 2 != 0)
+        throw exceptions::Exception("number of walkers must be even and positive", "EnsembleSampler::EnsembleSampler");
+
+    if (Integral_->integrals().size() != Model_->components().size())
+        throw exceptions::Exception("ModelIntegral is not of Model", "EnsembleSampler::EnsembleSampler");
+
+    Matrices_.reserve(FitPartitions_.size());
+    for (auto& P : FitPartitions_)
+        Matrices_.emplace_back(*Model_, *P);
+
+    // start workers
+    Workers_.reserve(FitPartitions_.size());
+    for (size_t p = 0; p < FitPartitions_.size(); ++p)
+        Workers_.emplace_back(&EnsembleSampler::work, this, p);
+
+    try {
+        prepare();
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+//-------------------------
+EnsembleSampler::~EnsembleSampler()
+{
+    // destructor must not throw
+    try {
+        stop();
+    } catch (...) {
+    }
+}
+
+//-------------------------
+void EnsembleSampler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex_);
+        Stop_ = true;
+    }
+    Start_.notify_all();
+    for (auto& w : Workers_)
+        if (w.joinable())
+            w.join();
+}
+
+//-------------------------
+void EnsembleSampler::work(size_t p)
+{
+    unsigned generation = 0;
+    while (true) {
+        const std::function<void(size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(Mutex_);
+            Start_.wait(lock, [&]() {return Stop_ or TaskGeneration_ != generation;});
+            if (Stop_)
+                return;
+            generation = TaskGeneration_;
+            task = Task_;
+        }
+
+        try {
+            (*task)(p);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(Mutex_);
+            if (!Error_)
+                Error_ = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(Mutex_);
+        if (--Pending_ == 0)
+            Done_.notify_one();
+    }
+}
+
+//-------------------------
+void EnsembleSampler::parallel(const std::function<void(size_t)>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex_);
+        Task_ = &task;
+        Pending_ = Workers_.size();
+        Error_ = nullptr;
+        ++TaskGeneration_;
+    }
+    Start_.notify_all();
+
+    std::unique_lock<std::mutex> lock(Mutex_);
+    Done_.wait(lock, [this]() {return Pending_ == 0;});
+    Task_ = nullptr;
+
+    // clear error, so that it is thrown only once
+    auto error = Error_;
+    Error_ = nullptr;
+    if (error)
+        std::rethrow_exception(error);
+}
+
+//-------------------------
+void EnsembleSampler::prepare()
+{
+    for (size_t c = 0; c < Model_->components().size(); ++c)
+        if (Integral_->integrals()[c].Integral.changed())
+            throw exceptions::Exception("ModelIntegral is out of date", "EnsembleSampler::prepare");
+
+    // free amplitudes and admixtures, in order of first appearance,
+    // and products of fixed free amplitudes, whose values may have changed
+    FreeAmplitudeVector free_amplitudes;
+    NonnegativeRealParameterVector admixtures;
+    std::vector<std::vector<std::complex<double> > > fixed_factors;
+    std::vector<std::vector<std::vector<size_t> > > free_factors;
+    std::vector<int> admixture_indices;
+
+    std::map<std::shared_ptr<FreeAmplitude>, size_t> index;
+    for (const auto& c : Model_->components()) {
+        const auto& plan = *c.amplitudePlan();
+        fixed_factors.emplace_back(plan.size(), 1.);
+        free_factors.emplace_back(plan.size());
+        for (size_t k = 0; k < plan.size(); ++k)
+            for (const auto& fa : plan.freeAmplitudes(k)) {
+                if (fa->variableStatus() == VariableStatus::fixed) {
+                    fixed_factors.back()[k] *= fa->value();
+                    continue;
+                }
+                auto it = index.find(fa);
+                if (it == index.end()) {
+                    it = index.emplace(fa, free_amplitudes.size()).first;
+                    free_amplitudes.push_back(fa);
+                }
+                free_factors.back()[k].push_back(it->second);
+            }
+
+        if (c.admixture()->variableStatus() == VariableStatus::fixed)
+            admixture_indices.push_back(-1);
+        else {
+            admixture_indices.push_back(admixtures.size());
+            admixtures.push_back(c.admixture());
+        }
+    }
+
+    // parameters are those found at construction
+    if (FixedFactors_.empty()) {
+        FreeAmplitudes_ = free_amplitudes;
+        Admixtures_ = admixtures;
+    } else if (free_amplitudes != FreeAmplitudes_ or admixtures != Admixtures_)
+        throw exceptions::Exception("free parameters of Model have changed", "EnsembleSampler::prepare");
+
+    FixedFactors_ = fixed_factors;
+    FreeFactors_ = free_factors;
+    AdmixtureIndices_ = admixture_indices;
+
+    // recalculate out-of-date columns of data-dependent amplitudes
+    parallel([this](size_t p) {Matrices_[p].update();});
+
+    NDataPoints_ = 0;
+    for (const auto& A : Matrices_)
+        NDataPoints_ += A.rows();
+
+    IntegralComponents_.clear();
+    for (const auto& mci : Integral_->integrals()) {
+        const auto n = mci.Integral.decayTrees().size();
+        IntegralComponents_.emplace_back(n, std::vector<std::complex<double> >(n));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                IntegralComponents_.back()[i][j] = mci.Integral.component(i, j).value();
+    }
+}
+
+//-------------------------
+std::vector<double> EnsembleSampler::parameters() const
+{
+    std::vector<double> x;
+    x.reserve(nParameters());
+    for (const auto& fa : FreeAmplitudes_) {
+        x.push_back(real(fa->value()));
+        x.push_back(imag(fa->value()));
+    }
+    for (const auto& adm : Admixtures_)
+        x.push_back(adm->value());
+    return x;
+}
+
+//-------------------------
+void EnsembleSampler::setStretchScale(double a)
+{
+    if (a <= 1)
+        throw exceptions::Exception("stretch scale must be greater than one", "EnsembleSampler::setStretchScale");
+    StretchScale_ = a;
+}
+
+//-------------------------
+std::vector<double> EnsembleSampler::logLikelihood(const std::vector<std::vector<double> >& X)
+{
+    std::vector<double> L(X.size(), -std::numeric_limits<double>::infinity());
+
+    // data-independent amplitudes, admixtures, and integrals of points in bounds
+    std::vector<size_t> W;
+    std::vector<std::vector<std::vector<std::complex<double> > > > a;
+    std::vector<std::vector<double> > adm;
+    std::vector<double> Norm;
+
+    for (size_t w = 0; w < X.size(); ++w) {
+        const auto& x = X[w];
+        if (x.size() != nParameters())
+            throw exceptions::Exception("wrong number of parameters", "EnsembleSampler::logLikelihood");
+        if (std::any_of(x.begin() + 2 * FreeAmplitudes_.size(), x.end(), [](double v) {return v < 0;}))
+            continue;
+
+        W.push_back(w);
+        a.emplace_back(FixedFactors_);
+        adm.emplace_back(Model_->components().size());
+        double N = 0;
+
+        for (size_t c = 0; c < FixedFactors_.size(); ++c) {
+            auto& a_c = a.back()[c];
+            for (size_t k = 0; k < a_c.size(); ++k)
+                for (auto f : FreeFactors_[c][k])
+                    a_c[k] *= std::complex<double>(x[2 * f], x[2 * f + 1]);
+
+            adm.back()[c] = AdmixtureIndices_[c] < 0
+                ? Model_->components()[c].admixture()->value()
+                : x[2 * FreeAmplitudes_.size() + AdmixtureIndices_[c]];
+
+            std::complex<double> N_c = 0.;
+            for (size_t i = 0; i < a_c.size(); ++i)
+                for (size_t j = 0; j < a_c.size(); ++j)
+                    N_c += conj(a_c[i]) * a_c[j] * IntegralComponents_[c][i][j];
+            N += adm.back()[c] * real(N_c);
+        }
+        Norm.push_back(N);
+    }
+
+    if (W.empty())
+        return L;
+
+    // sums of logs of intensities, by partition and point
+    std::vector<std::vector<CompensatedSum<double> > > partial_sums(Matrices_.size(), std::vector<CompensatedSum<double> >(W.size(), 0.));
+
+    parallel([&](size_t p) {
+            const auto& A = Matrices_[p];
+            auto& sums = partial_sums[p];
+            double re[block_size], im[block_size], I[block_size];
+
+            for (size_t r0 = 0; r0 < A.rows(); r0 += block_size) {
+                const size_t n = std::min(block_size, A.rows() - r0);
+
+                for (size_t w = 0; w < W.size(); ++w) {
+                    std::fill(I, I + n, 0.);
+                    for (size_t c = 0; c < a[w].size(); ++c) {
+                        std::fill(re, re + n, 0.);
+                        std::fill(im, im + n, 0.);
+                        for (size_t k = 0; k < a[w][c].size(); ++k) {
+                            const auto ar = real(a[w][c][k]);
+                            const auto ai = imag(a[w][c][k]);
+                            const auto* col = A.column(c, k).data() + r0;
+                            for (size_t i = 0; i < n; ++i) {
+                                re[i] += ar * real(col[i]) - ai * imag(col[i]);
+                                im[i] += ar * imag(col[i]) + ai * real(col[i]);
+                            }
+                        }
+                        for (size_t i = 0; i < n; ++i)
+                            I[i] += adm[w][c] * (re[i] * re[i] + im[i] * im[i]);
+                    }
+                    for (size_t i = 0; i < n; ++i)
+                        sums[w] += log(I[i]);
+                }
+            }
+        });
+
+    for (size_t w = 0; w < W.size(); ++w) {
+        CompensatedSum<double> l = -(NDataPoints_ * log(Norm[w]));
+        for (const auto& ps : partial_sums)
+            l += ps[w].sum;
+        L[W[w]] = std::isnan(l.sum) ? -std::numeric_limits<double>::infinity() : l.sum;
+    }
+
+    return L;
+}
+
+//-------------------------
+void EnsembleSampler::initialize(double spread)
+{
+    // model or integral may have changed
+    prepare();
+
+    auto x0 = parameters();
+    std::normal_distribution<double> normal;
+
+    Walkers_.assign(NWalkers_, x0);
+    for (auto& x : Walkers_) {
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] += spread * std::max(std::abs(x0[i]), 1.) * normal(Generator_);
+        // admixtures are nonnegative
+        for (size_t i = 2 * FreeAmplitudes_.size(); i < x.size(); ++i)
+            x[i] = std::abs(x[i]);
+    }
+
+    LogLikelihoods_ = logLikelihood(Walkers_);
+    Proposals_ = 0;
+    Accepted_ = 0;
+}
+
+//-------------------------
+void EnsembleSampler::run(unsigned n_steps)
+{
+    if (Walkers_.empty())
+        initialize();
+    else {
+        // model or integral may have changed
+        prepare();
+        LogLikelihoods_ = logLikelihood(Walkers_);
+    }
+
+    const unsigned half = NWalkers_ / 2;
+    const double n = nParameters();
+    std::uniform_real_distribution<double> uniform;
+    std::uniform_int_distribution<unsigned> partner(0, half - 1);
+
+    for (unsigned step = 0; step < n_steps; ++step) {
+
+        // move each half of walkers using other half
+        for (unsigned h = 0; h < 2; ++h) {
+            const unsigned first = h * half;
+            const unsigned other = (1 - h) * half;
+
+            // propose stretch moves, with stretch z drawn from g(z) ~ 1 / sqrt(z) on [1/a, a]
+            std::vector<std::vector<double> > Y(half);
+            std::vector<double> z(half);
+            for (unsigned k = 0; k < half; ++k) {
+                const auto& x_k = Walkers_[first + k];
+                const auto& x_j = Walkers_[other + partner(Generator_)];
+                z[k] = std::pow((StretchScale_ - 1.) * uniform(Generator_) + 1., 2) / StretchScale_;
+                Y[k].resize(x_k.size());
+                for (size_t i = 0; i < x_k.size(); ++i)
+                    Y[k][i] = x_j[i] + z[k] * (x_k[i] - x_j[i]);
+            }
+
+            auto L = logLikelihood(Y);
+
+            for (unsigned k = 0; k < half; ++k) {
+                ++Proposals_;
+                auto log_q = (n - 1) * log(z[k]) + L[k] - LogLikelihoods_[first + k];
+                if (std::isfinite(L[k]) and log(uniform(Generator_)) < log_q) {
+                    Walkers_[first + k] = std::move(Y[k]);
+                    LogLikelihoods_[first + k] = L[k];
+                    ++Accepted_;
+                }
+            }
+        }
+
+        if (ChainFile_.is_open()) {
+            for (unsigned w = 0; w < NWalkers_; ++w) {
+                ChainFile_.write(reinterpret_cast<const char*>(Walkers_[w].data()), Walkers_[w].size() * sizeof(double));
+                ChainFile_.write(reinterpret_cast<const char*>(&LogLikelihoods_[w]), sizeof(double));
+            }
+            if (!ChainFile_)
+                throw exceptions::Exception("could not write chain file", "EnsembleSampler::run");
+        }
+    }
+
+    if (ChainFile_.is_open())
+        ChainFile_.flush();
+}
+
+//-------------------------
+void EnsembleSampler::openChainFile(const std::string& filename)
+{
+    closeChainFile();
+
+    ChainFile_.open(filename, std::ios::binary | std::ios::trunc);
+    if (!ChainFile_)
+        throw exceptions::Exception("could not open " + filename, "EnsembleSampler::openChainFile");
+
+    Header h;
+    std::copy(magic, magic + 8, h.Magic);
+    h.Version = version;
+    h.NParameters = nParameters();
+    h.NWalkers = NWalkers_;
+    ChainFile_.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+}
+
+//-------------------------
+void EnsembleSampler::closeChainFile()
+{
+    if (ChainFile_.is_open())
+        ChainFile_.close();
+}
+
+}
@@ -1,18 +1,18 @@
 #include "Flatte.h"
 
-#include "CalculationStatus.h"
-#include "DataPoint.h"
 #include "DataPartition.h"
 #include "DecayChannel.h"
 #include "Exceptions.h"
 #include "FinalStateParticle.h"
-#include "FourMomenta.h"
 #include "logging.h"
 #include "MeasuredBreakupMomenta.h"
-#include "Model.h"
 #include "Parameter.h"
 #include "ParticleTable.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 namespace yap {
 
 //-------------------------
@@ -37,15 +37,13 @@ FlatteChannel::FlatteChannel(double coupling, const ParticleTableEntry& a, const
 
 //-------------------------
 Flatte::Flatte(double m) :
-    MassShapeWithNominalMass(m),
-    T_(ComplexCachedValue::create(*this))
+    MassShapeWithNominalMass(m)
 {
 }
 
 //-------------------------
 Flatte::Flatte(const ParticleTableEntry& pde) :
-    MassShapeWithNominalMass(pde),
-    T_(ComplexCachedValue::create(*this))
+    MassShapeWithNominalMass(pde)
 {
 }
 
@@ -62,6 +60,8 @@ void Flatte::add(FlatteChannel fc)
             throw exceptions::Exception("Channel already held", "Flatte::add");
 
     FlatteChannels_.push_back(fc);
+    ThresholdM2_.push_back(pow(fc.Particles[0]->mass() + fc.Particles[1]->mass(), 2));
+    PseudothresholdM2_.push_back(pow(fc.Particles[0]->mass() - fc.Particles[1]->mass(), 2));
 
     addParameter(FlatteChannels_.back().Coupling);
 }
@@ -90,25 +90,8 @@ void Flatte::checkDecayChannel(const DecayChannel& c) const
 }
     
 //-------------------------
-void Flatte::updateCalculationStatus(StatusManager& D) const
+void Flatte::calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const
 {
-    if (status() == VariableStatus::changed)
-        D.set(*T_, CalculationStatus::uncalculated);
-}
-
-//-------------------------
-const std::complex<double> Flatte::value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
-{
-    return T_->value(d, symmetrizationIndex(pc));
-}
-    
-//-------------------------
-void Flatte::calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const
-{
-    // if no calculation necessary, exit
-    if (D.status(*T_, si) != CalculationStatus::uncalculated)
-        return;
-
     /////////////////////////
     // common factors:
 
@@ -125,20 +108,32 @@ void Flatte::calculate(DataPartition& D, const std::shared_ptr<const ParticleCom
 
     /////////////////////////
 
-    for (auto& d : D) {
-        
-        auto s = model()->fourMomenta()->m2(d, pc);
-
-        // calculate width term := sum of coupling * complex-breakup-momentum
-        std::complex<double> ws = 0;
-        for (const auto& fc : FlatteChannels_)
-            ws += fc.Coupling->value() * std::sqrt(std::complex<double>(measured_breakup_momenta::q2(s, fc.Particles[0]->mass(), fc.Particles[1]->mass())));
-
-        // T = 1 / (M^2 - m^2 - width-term)
-        T_->setValue(w_o_m / (m2 - s - 1_i * 2. * ws / sqrt(s)), d, si, D);
+    // width term := sum of coupling * complex-breakup-momentum,
+    // with real and imaginary parts accumulated separately
+    std::array<double, batch_size> ws_re;
+    std::array<double, batch_size> ws_im;
+    std::fill_n(ws_re.begin(), B.Size, 0.);
+    std::fill_n(ws_im.begin(), B.Size, 0.);
+
+    for (size_t c = 0; c < FlatteChannels_.size(); ++c) {
+        const double g = FlatteChannels_[c].Coupling->value();
+        const double m2_sum = ThresholdM2_[c];
+        const double m2_diff = PseudothresholdM2_[c];
+        for (size_t i = 0; i < B.Size; ++i) {
+            // squared breakup momentum, negative below threshold
+            double q2 = (B.M2[i] - m2_sum) * (B.M2[i] - m2_diff) / B.M2[i] / 4.;
+            // sqrt(q2) is real above threshold and imaginary below
+            double gq = g * sqrt(std::abs(q2));
+            ws_re[i] += (q2 >= 0) * gq;
+            ws_im[i] += (q2 < 0) * gq;
+        }
     }
 
-    D.status(*T_, si) = CalculationStatus::calculated;
+    // T = 1 / (M^2 - m^2 - i * 2 * width-term / m)
+    for (size_t i = 0; i < B.Size; ++i) {
+        double two_o_m = 2. / sqrt(B.M2[i]);
+        B.T[i] = w_o_m / std::complex<double>(m2 - B.M2[i] + two_o_m * ws_im[i], -two_o_m * ws_re[i]);
+    }
 }
 
 }
@@ -3,6 +3,7 @@
 #include "CachedValue.h"
 #include "CalculationStatus.h"
 #include "container_utils.h"
+#include "DataPartition.h"
 #include "DecayingParticle.h"
 #include "Exceptions.h"
 #include "FinalStateParticle.h"
@@ -14,6 +15,7 @@
 #include "ParticleCombination.h"
 #include "StatusManager.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -99,6 +101,19 @@ double FourMomenta::m(const DataPoint& d, const std::shared_ptr<const ParticleCo
         M_->value(d, symmetrizationIndex(pc));
 }
 
+//-------------------------
+void FourMomenta::m(DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc, double* m) const
+{
+    if (is_final_state_particle_combination(*pc)) {
+        std::fill(m, m + n, model()->finalStateParticles()[pc->indices()[0]]->mass());
+        return;
+    }
+
+    auto si = symmetrizationIndex(pc);
+    for (size_t i = 0; i < n; ++i, ++first)
+        m[i] = M_->value(*first, si);
+}
+
 //-------------------------
 void FourMomenta::calculate(DataPoint& d, StatusManager& sm) const
 {
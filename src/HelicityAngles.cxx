@@ -1,5 +1,8 @@
 #include "HelicityAngles.h"
 
+#include "CachedValue.h"
+#include "CalculationStatus.h"
+#include "Exceptions.h"
 #include "FourMomenta.h"
 #include "FourVector.h"
 #include "LorentzTransformation.h"
@@ -9,99 +12,98 @@
 
 namespace yap {
 
+//-------------------------
+HelicityAngles::HelicityAngles(Model& m) :
+    StaticDataAccessor(m, equal_up_and_down),
+    Phi_(RealCachedValue::create(*this)),
+    Theta_(RealCachedValue::create(*this))
+{
+    registerWithModel();
+}
 
 //-------------------------
-const spherical_angles<double>& HelicityAngles::operator()(const DataPoint& d, const StatusManager& sm, const std::shared_ptr<const ParticleCombination>& pc) const
+const spherical_angles<double> HelicityAngles::operator()(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
 {
-    // check if StatusManager is in cache
-    auto it = CachedAngles_.find(&sm);
-    if (CachedAngles_.find(&sm) == CachedAngles_.end()) {
-        addToCache(sm);
-        it = CachedAngles_.find(&sm);
-    }
+    auto it = symmetrizationIndices().find(pc);
 
-    // get entries for status manager
-    angles_cache& cachedAngles = it->second;
-    auto& cachedForDataPoint = CachedForDataPoint_.at(&sm);
+    // if not stored, calculate
+    if (it == symmetrizationIndices().end())
+        return calculateAngles(d, pc);
 
+    return spherical_angles<double>(Phi_->value(d, it->second), Theta_->value(d, it->second));
+}
 
-    // check if DataPoint is currently in cache
-    if (cachedForDataPoint == &d) {
-        // find and return entry
-        for (const auto& pc_angles : cachedAngles)
-            if (equal_up_and_down(pc_angles.first, pc))
-                return pc_angles.second;
-    }
-    else {
-        // reset and clear
-        cachedForDataPoint = nullptr;
-        cachedAngles.clear();
-    }
+//-------------------------
+void HelicityAngles::calculate(DataPoint& d, StatusManager& sm) const
+{
+    // if no angles stored, do nothing
+    if (symmetrizationIndices().empty())
+        return;
 
-    // if not found, calculate
-    calculateAngles(d, sm, origin(*pc).shared_from_this(), Model_->coordinateSystem(), unitMatrix<double, 4>());
-    cachedForDataPoint = &d;
+    // set all angles as uncalculated
+    sm.set(*Phi_, CalculationStatus::uncalculated);
+    sm.set(*Theta_, CalculationStatus::uncalculated);
 
-    // find and return entry
-    for (const auto& pc_angles : cachedAngles)
-        if (equal_up_and_down(pc_angles.first, pc))
-            return pc_angles.second;
+    for (const auto& kv : symmetrizationIndices()) {
 
-    throw exceptions::Exception("Cannot find entry for DataPoint and ParticleCombination even though it should have been calculated. Something went wrong!", "HelicityAngles::operator()");
-}
+        // check if calculation unnecessary
+        if (sm.status(*Phi_, kv.second) == CalculationStatus::calculated)
+            continue;
 
-//-------------------------
-void HelicityAngles::addToCache(const StatusManager& sm) const
-{
-    std::lock_guard<std::mutex> guard(CacheMutex_);
-    CachedForDataPoint_[&sm] = nullptr;
-    CachedAngles_[&sm].clear();
-}
+        auto hel_angles = calculateAngles(d, kv.first);
 
-//-------------------------
-void HelicityAngles::clearCache(const StatusManager& sm) const 
-{
-    std::lock_guard<std::mutex> guard(CacheMutex_);
-    if (CachedAngles_.find(&sm) != CachedAngles_.end()) {
-        CachedAngles_.at(&sm).clear();
-        CachedForDataPoint_.at(&sm) = nullptr;
+        Phi_->setValue(hel_angles.phi, d, kv.second, sm);
+        Theta_->setValue(hel_angles.theta, d, kv.second, sm);
     }
 }
 
 //-------------------------
-void HelicityAngles::calculateAngles(const DataPoint& d, const StatusManager& sm,
-                                     const std::shared_ptr<const ParticleCombination>& pc,
-                                     const CoordinateSystem<double, 3>& C, const FourMatrix<double>& boosts) const
+spherical_angles<double> HelicityAngles::calculateAngles(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
 {
-    // terminate recursion
-    if (is_final_state_particle_combination(*pc))
-        return;
+    // collect decay chain from pc up to its origin
+    ParticleCombinationVector chain(1, pc);
+    while (chain.back()->parent())
+        chain.push_back(chain.back()->parent());
+
+    const auto& fm = *model()->fourMomenta();
 
-    // get pc's 4-mom in data frame
-    const auto P = Model_->fourMomenta()->p(d, pc);
+    // reference frame and boost from data frame into parent's rest frame
+    auto C = model()->coordinateSystem();
+    auto boosts = unitMatrix<double, 4>();
 
-    // calculate reference frame for P from parent's RF
-    const auto cP = helicityFrame(boosts * P, C);
+    // travel down the chain to pc
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
 
-    // calculate boost from data frame into pc rest frame
-    const auto boost = lorentzTransformation(-(boosts * P));
+        // get pc's 4-mom in data frame
+        const auto P = fm.p(d, *it);
 
-    // boost daughter momentum from data frame into pc rest frame
-    const auto p = boost * boosts * Model_->fourMomenta()->p(d, pc->daughters()[0]);
+        // calculate reference frame for P from parent's RF
+        const auto cP = helicityFrame(boosts * P, C);
 
-    auto hel_angles = angles<double>(vect<double>(p), cP);
+        // calculate boost from data frame into pc rest frame
+        const auto boost = lorentzTransformation(-(boosts * P));
 
-    // set ambiguous phi to theta
-    // todo: in this cases, theta should be 0 or pi. In most cases it is, but sometimes not.
-    // Not checking if theta == 0 or pi results in tests passing which would otherwise not
-    if (std::isnan(hel_angles.phi))
-        hel_angles.phi = hel_angles.theta;
+        if (*it == pc) {
 
-    CachedAngles_.at(&sm)[pc] = hel_angles;
+            // boost daughter momentum from data frame into pc rest frame
+            const auto p = boost * boosts * fm.p(d, pc->daughters()[0]);
+
+            auto hel_angles = angles<double>(vect<double>(p), cP);
+
+            // set ambiguous phi to theta
+            // todo: in this cases, theta should be 0 or pi. In most cases it is, but sometimes not.
+            // Not checking if theta == 0 or pi results in tests passing which would otherwise not
+            if (std::isnan(hel_angles.phi))
+                hel_angles.phi = hel_angles.theta;
+
+            return hel_angles;
+        }
+
+        C = cP;
+        boosts = boost;
+    }
 
-    for (auto& daughter : pc->daughters())
-        // recurse down the decay tree
-        calculateAngles(d, sm, daughter, cP, boost);
+    throw exceptions::Exception("ParticleCombination not found in its own decay chain", "HelicityAngles::calculateAngles");
 }
 
 }
@@ -1,14 +1,19 @@
 #include "HelicityFormalism.h"
 
+#include "AmplitudePlan.h"
 #include "CachedValue.h"
+#include "CalculationStatus.h"
 #include "ClebschGordan.h"
 #include "Exceptions.h"
 #include "HelicityAngles.h"
 #include "logging.h"
 #include "Model.h"
 #include "Spin.h"
+#include "StatusManager.h"
 #include "WignerD.h"
 
+#include <vector>
+
 namespace yap {
 
 //-------------------------
@@ -40,10 +45,14 @@ HelicitySpinAmplitude::HelicitySpinAmplitude(Model& m, unsigned two_J, const Spi
             Coefficients_[two_m] = c * CG;
 
             // add amplitudes for all initial spin projections
-            for (auto two_M : projections(initialTwoJ()))
+            for (auto two_M : projections(initialTwoJ())) {
                 // for J==0, only the Clebsch-Gordan coefficients are returned
-                // ==> we don't need storage space in the DataPoint
-                addAmplitude(two_M, two_m, initialTwoJ() == 0);
+                // ==> we don't need storage space in the DataPoint;
+                // since |D| <= 1, amplitudes are bounded by the coefficients
+                auto i = addAmplitude(two_M, two_m, initialTwoJ() == 0, std::abs(Coefficients_[two_m]));
+                AmplitudeCoefficients_.resize(i + 1);
+                AmplitudeCoefficients_[i] = Coefficients_[two_m];
+            }
 
         } catch (const exceptions::InconsistentSpinProjection&) { /* ignore */ }
 
@@ -51,13 +60,68 @@ HelicitySpinAmplitude::HelicitySpinAmplitude(Model& m, unsigned two_J, const Spi
         throw exceptions::Exception("no valid nonzero Clebsch-Gordan coefficients stored", "HelicitySpinAmplitude::HelicitySpinAmplitude");
 }
 
+//-------------------------
+AmplitudeFactor HelicitySpinAmplitude::factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const
+{
+    return (initialTwoJ() == 0) ? AmplitudeFactor(AmplitudeCoefficients_[i]) : SpinAmplitude::factor(pc, i);
+}
+
+//-------------------------
+void HelicitySpinAmplitude::registerWithModel()
+{
+    SpinAmplitude::registerWithModel();
+
+    // for J == 0, amplitudes are constant and need no helicity angles
+    if (initialTwoJ() == 0)
+        return;
+
+    for (const auto& pc_i : symmetrizationIndices())
+        const_cast<Model*>(model())->helicityAngles().addParticleCombination(*pc_i.first);
+}
+
+//-------------------------
+void HelicitySpinAmplitude::calculate(DataPoint& d, StatusManager& sm) const
+{
+    // for J == 0, amplitudes are constant
+    if (initialTwoJ() == 0)
+        return;
+
+    // set all amplitudes uncalculated
+    sm.set(*this, CalculationStatus::uncalculated);
+
+    // d-matrix elements
+    std::vector<double> dJ((initialTwoJ() + 1) * (initialTwoJ() + 1));
+
+    // conj(exp(-i M phi)), indexed by (J + M)
+    std::vector<std::complex<double> > phase(initialTwoJ() + 1);
+
+    for (const auto& pc_i : symmetrizationIndices()) {
+
+        // helicity angles
+        const auto angles = model()->helicityAngles()(d, pc_i.first);
+
+        dMatrix::calculate(initialTwoJ(), &angles.theta, 1, dJ.data());
+
+        for (int two_M = -initialTwoJ(); two_M <= (int)initialTwoJ(); two_M += 2)
+            phase[(initialTwoJ() + two_M) / 2] = std::exp(1_i * (angles.phi * two_M) / 2.);
+
+        for (size_t i = 0; i < amplitudes().size(); ++i)
+            if (sm.status(*amplitudes()[i], pc_i.second) == CalculationStatus::uncalculated) {
+                const auto& two_m = finalTwoM(i);
+                amplitudes()[i]->setValue(phase[(initialTwoJ() + initialTwoM(i)) / 2]
+                                          * dJ[dMatrix::index(initialTwoJ(), initialTwoM(i), two_m[0] - two_m[1])]
+                                          * AmplitudeCoefficients_[i], d, pc_i.second, sm);
+            }
+    }
+}
+
 //-------------------------
 const std::complex<double> HelicitySpinAmplitude::calc(int two_M, const SpinProjectionVector& two_m,
         const DataPoint& d, const StatusManager& sm,
         const std::shared_ptr<const ParticleCombination>& pc) const
 {
     // helicity angles
-    const auto& angles = model()->helicityAngles()(d, sm, pc);
+    const auto angles = model()->helicityAngles()(d, pc);
 
     return std::conj(DFunction(initialTwoJ(), two_M, two_m[0] - two_m[1], angles.phi, angles.theta, 0))
            * Coefficients_.at(two_m);
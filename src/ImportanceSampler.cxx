@@ -85,14 +85,14 @@ std::vector<DecayTreeVectorIntegral*> ImportanceSampler::select_changed(ModelInt
     C.reserve(integrals(I).size());
 
     for (auto& mci : integrals(I))
-        if (std::any_of(mci.Integral.decayTrees().begin(), mci.Integral.decayTrees().end(), &has_changed))
+        if (mci.Integral.changed())
             C.push_back(&mci.Integral);
 
     return C;
 }
 
 //-------------------------
-void ImportanceSampler::calculate(ModelIntegral& I, Generator g, unsigned N, unsigned n, unsigned t)
+void ImportanceSampler::calculate(ModelIntegral& I, Generator g, unsigned N, unsigned n, unsigned t, StoragePrecision precision)
 {
     // get DecayTreeVectorIntegral's for DecayTree's that need to be calculated
     auto J = select_changed(I);
@@ -107,7 +107,7 @@ void ImportanceSampler::calculate(ModelIntegral& I, Generator g, unsigned N, uns
 
     if (t <= 1) {
 
-        calculate_subset(J, g, N, n);
+        calculate_subset(J, g, N, n, precision);
 
     } else {
 
@@ -131,7 +131,7 @@ void ImportanceSampler::calculate(ModelIntegral& I, Generator g, unsigned N, uns
         for (size_t i = 0; i < m.size(); ++i) {
             int nn = NN / (m.size() - i);
             n_sub.push_back(std::async(std::launch::async, &ImportanceSampler::calculate_subset,
-                                       std::ref(m[i]), g, nn, n / t));
+                                       std::ref(m[i]), g, nn, n / t, precision));
             NN -= nn;
         }
 
@@ -150,7 +150,7 @@ void ImportanceSampler::calculate(ModelIntegral& I, Generator g, unsigned N, uns
 }
 
 //-------------------------
-unsigned ImportanceSampler::calculate_subset(std::vector<DecayTreeVectorIntegral*>& J, Generator g, unsigned N, unsigned n)
+unsigned ImportanceSampler::calculate_subset(std::vector<DecayTreeVectorIntegral*>& J, Generator g, unsigned N, unsigned n, StoragePrecision precision)
 {
     if (!J[0]->model())
         throw exceptions::Exception("Model is nullptr", "ImportanceSampler::partially_calculate");
@@ -162,7 +162,7 @@ unsigned ImportanceSampler::calculate_subset(std::vector<DecayTreeVectorIntegral
                    {return std::vector<std::complex<double> >(j->decayTrees().size());});
 
     // create DataSet and DataPoint
-    auto data = const_cast<Model*>(J[0]->model())->createDataSet();
+    auto data = const_cast<Model*>(J[0]->model())->createDataSet(0, precision);
 
     // calculate
     for (unsigned k = 0; k < N;) {
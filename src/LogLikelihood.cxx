@@ -0,0 +1,459 @@
+#include "LogLikelihood.h"
+
+#include "AmplitudePlan.h"
+#include "CompensatedSum.h"
+#include "DataPartition.h"
+#include "DataPoint.h"
+#include "DecayTreeVectorIntegral.h"
+#include "Exceptions.h"
+#include "FreeAmplitude.h"
+#include "IntegralElement.h"
+#include "Model.h"
+#include "ModelIntegral.h"
+#include "Parameter.h"
+#include "VariableStatus.h"
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <tuple>
+
+namespace yap {
+
+namespace {
+
+//-------------------------
+// derivatives of the data-independent amplitude of a decay tree (a
+// product of free amplitudes) with respect to the non-fixed free
+// amplitudes it contains, which it depends on holomorphically: so
+// d a / d Re(f) = a'(f) and d a / d Im(f) = i * a'(f)
+struct TreeDerivatives
+{
+    // index of free amplitude and first derivative
+    std::vector<std::pair<size_t, std::complex<double> > > First;
+
+    // indices of free amplitudes (f <= g) and mixed second derivative
+    std::vector<std::tuple<size_t, size_t, std::complex<double> > > Second;
+};
+
+//-------------------------
+// derivatives of all decay trees of a model, by component and tree
+struct Derivatives
+{
+    // non-fixed free amplitudes, in order of first appearance
+    FreeAmplitudeVector FreeAmplitudes;
+
+    // derivatives of each tree, by component and tree
+    std::vector<std::vector<TreeDerivatives> > Trees;
+
+    // number of real parameters: real and imaginary part of each free amplitude
+    size_t nParameters() const
+    { return 2 * FreeAmplitudes.size(); }
+};
+
+//-------------------------
+// derivative of product of free amplitudes with respect to fa
+std::complex<double> derivative(const FreeAmplitudeVector& fav, const std::shared_ptr<FreeAmplitude>& fa)
+{
+    std::complex<double> D = 0.;
+    for (size_t j = 0; j < fav.size(); ++j) {
+        if (fav[j] != fa)
+            continue;
+        std::complex<double> d = 1.;
+        for (size_t r = 0; r < fav.size(); ++r)
+            if (r != j)
+                d *= fav[r]->value();
+        D += d;
+    }
+    return D;
+}
+
+//-------------------------
+// second derivative of product of free amplitudes with respect to fa and fb
+std::complex<double> derivative(const FreeAmplitudeVector& fav, const std::shared_ptr<FreeAmplitude>& fa, const std::shared_ptr<FreeAmplitude>& fb)
+{
+    std::complex<double> D = 0.;
+    for (size_t j = 0; j < fav.size(); ++j) {
+        if (fav[j] != fa)
+            continue;
+        for (size_t m = 0; m < fav.size(); ++m) {
+            if (m == j or fav[m] != fb)
+                continue;
+            std::complex<double> d = 1.;
+            for (size_t r = 0; r < fav.size(); ++r)
+                if (r != j and r != m)
+                    d *= fav[r]->value();
+            D += d;
+        }
+    }
+    return D;
+}
+
+//-------------------------
+Derivatives derivatives(const Model& M, bool second)
+{
+    Derivatives D;
+
+    // index of each non-fixed free amplitude in D.FreeAmplitudes
+    std::map<std::shared_ptr<FreeAmplitude>, size_t> index;
+
+    D.Trees.reserve(M.components().size());
+    for (const auto& c : M.components()) {
+        const auto& plan = *c.amplitudePlan();
+        D.Trees.emplace_back(plan.size());
+
+        for (size_t k = 0; k < plan.size(); ++k) {
+            const auto& fav = plan.freeAmplitudes(k);
+
+            // positions of first appearance of each non-fixed free amplitude in fav
+            std::vector<size_t> J;
+            for (size_t j = 0; j < fav.size(); ++j)
+                if (fav[j]->variableStatus() != VariableStatus::fixed
+                    and std::find(fav.begin(), fav.begin() + j, fav[j]) == fav.begin() + j)
+                    J.push_back(j);
+
+            auto& td = D.Trees.back()[k];
+            for (auto j : J) {
+                auto it = index.find(fav[j]);
+                if (it == index.end()) {
+                    it = index.emplace(fav[j], D.FreeAmplitudes.size()).first;
+                    D.FreeAmplitudes.push_back(fav[j]);
+                }
+                td.First.emplace_back(it->second, derivative(fav, fav[j]));
+            }
+
+            if (!second)
+                continue;
+
+            for (size_t j = 0; j < J.size(); ++j)
+                for (size_t m = j; m < J.size(); ++m) {
+                    auto d2 = derivative(fav, fav[J[j]], fav[J[m]]);
+                    if (d2 == 0.)
+                        continue;
+                    auto f = index[fav[J[j]]];
+                    auto g = index[fav[J[m]]];
+                    td.Second.emplace_back(std::min(f, g), std::max(f, g), d2);
+                }
+        }
+    }
+
+    return D;
+}
+
+//-------------------------
+// sums over data points of the log of the intensity, of the
+// derivatives of the log of the intensity with respect to the
+// data-independent amplitudes of each component's decay trees and
+// with respect to the admixture of each component, and (if
+// requested) of the part of the Hessian of the log of the intensity
+// not involving second derivatives of the data-independent amplitudes
+struct DataSums
+{
+    CompensatedSum<double> LogIntensity;
+    size_t N;
+    std::vector<std::vector<std::complex<double> > > Amplitudes;
+    std::vector<double> Admixtures;
+    std::vector<std::vector<double> > Hessian;
+
+    DataSums(const Model& M, size_t n_parameters) :
+        LogIntensity(0.), N(0), Admixtures(M.components().size(), 0.),
+        Hessian(n_parameters, std::vector<double>(n_parameters, 0.))
+    {
+        Amplitudes.reserve(M.components().size());
+        for (const auto& c : M.components())
+            Amplitudes.emplace_back(c.amplitudePlan()->size(), 0.);
+    }
+
+    DataSums& operator+=(const DataSums& rhs)
+    {
+        LogIntensity += rhs.LogIntensity.sum;
+        N += rhs.N;
+        for (size_t c = 0; c < Amplitudes.size(); ++c) {
+            for (size_t k = 0; k < Amplitudes[c].size(); ++k)
+                Amplitudes[c][k] += rhs.Amplitudes[c][k];
+            Admixtures[c] += rhs.Admixtures[c];
+        }
+        for (size_t p = 0; p < Hessian.size(); ++p)
+            for (size_t q = p; q < Hessian.size(); ++q)
+                Hessian[p][q] += rhs.Hessian[p][q];
+        return *this;
+    }
+};
+
+//-------------------------
+// intensity is I = sum_c adm_c * |S_c|^2, with S_c = sum_k a_ck * A_ck;
+// so d log(I) / d a_ck = adm_c * conj(S_c) * A_ck / I (treating a_ck and
+// its conjugate as independent) and d log(I) / d adm_c = |S_c|^2 / I;
+// and for real parameters p and q, d^2 log(I) / dp dq =
+// sum_c adm_c * 2 Re(conj(dS_c/dq) * dS_c/dp + conj(S_c) * d^2S_c/dpdq) / I - (dI/dp / I) * (dI/dq / I),
+// of which the second derivative of S_c is accounted for later through the sum over d log(I) / d a_ck
+DataSums data_sums(const Model& M, DataPartition& D, const Derivatives& Der, bool hessian, unsigned n_threads)
+{
+    M.calculate(D, n_threads);
+
+    // data-independent amplitudes and admixtures, evaluated once for all data points
+    std::vector<std::vector<std::complex<double> > > a;
+    std::vector<double> adm;
+    a.reserve(M.components().size());
+    adm.reserve(M.components().size());
+    for (const auto& c : M.components()) {
+        a.push_back(c.amplitudePlan()->dataIndependentAmplitudes());
+        adm.push_back(c.admixture()->value());
+    }
+
+    auto P = hessian ? Der.nParameters() : 0;
+    DataSums s(M, P);
+
+    // data-dependent amplitudes of current data point
+    auto A = a;
+    std::vector<std::complex<double> > S(a.size());
+
+    // derivatives of S_c and of log(I) with respect to real parameters
+    std::vector<std::vector<std::complex<double> > > dS(a.size(), std::vector<std::complex<double> >(P));
+    std::vector<double> g(P);
+
+    for (const auto& d : D) {
+        double I = 0;
+        for (size_t c = 0; c < a.size(); ++c) {
+            const auto& plan = *M.components()[c].amplitudePlan();
+            S[c] = 0.;
+            for (size_t k = 0; k < a[c].size(); ++k) {
+                A[c][k] = plan.dataDependentAmplitude(d, k);
+                S[c] += a[c][k] * A[c][k];
+            }
+            I += adm[c] * norm(S[c]);
+        }
+
+        s.LogIntensity += log(I);
+        ++s.N;
+
+        for (size_t c = 0; c < a.size(); ++c) {
+            auto w = adm[c] * conj(S[c]) / I;
+            for (size_t k = 0; k < a[c].size(); ++k)
+                s.Amplitudes[c][k] += w * A[c][k];
+            s.Admixtures[c] += norm(S[c]) / I;
+        }
+
+        if (!hessian)
+            continue;
+
+        std::fill(g.begin(), g.end(), 0.);
+        for (size_t c = 0; c < a.size(); ++c) {
+            std::fill(dS[c].begin(), dS[c].end(), 0.);
+            for (size_t k = 0; k < a[c].size(); ++k)
+                for (const auto& f_da : Der.Trees[c][k].First) {
+                    auto dA = f_da.second * A[c][k];
+                    dS[c][2 * f_da.first] += dA;
+                    dS[c][2 * f_da.first + 1] += std::complex<double>(0, 1) * dA;
+                }
+            for (size_t p = 0; p < P; ++p)
+                g[p] += 2. * adm[c] * real(conj(S[c]) * dS[c][p]) / I;
+        }
+
+        // upper triangle only
+        for (size_t p = 0; p < P; ++p)
+            for (size_t q = p; q < P; ++q) {
+                double h = -g[p] * g[q];
+                for (size_t c = 0; c < a.size(); ++c)
+                    h += 2. * adm[c] * real(conj(dS[c][q]) * dS[c][p]) / I;
+                s.Hessian[p][q] += h;
+            }
+    }
+
+    return s;
+}
+
+//-------------------------
+void check(const Model& M, const ModelIntegral& MI, const std::string& func)
+{
+    if (!M.locked())
+        throw exceptions::Exception("Model is not locked", func);
+
+    if (MI.integrals().size() != M.components().size())
+        throw exceptions::Exception("ModelIntegral is not of Model", func);
+
+    for (size_t c = 0; c < M.components().size(); ++c) {
+        if (MI.integrals()[c].Integral.decayTrees() != M.components()[c].decayTrees())
+            throw exceptions::Exception("ModelIntegral is not of Model", func);
+        if (MI.integrals()[c].Integral.changed())
+            throw exceptions::Exception("ModelIntegral is out of date", func);
+    }
+}
+
+//-------------------------
+// combine sums over data with integral; the normalization
+// Norm = sum_c adm_c * sum_ij conj(a_ci) * a_cj * M_cij contributes
+// -N * log(Norm) to the log-likelihood
+const LogLikelihood combine(const Model& M, const ModelIntegral& MI, const Derivatives& Der, const DataSums& s, bool hessian)
+{
+    auto Norm = integral(MI).value();
+    auto r = s.N / Norm;
+    auto P = Der.nParameters();
+
+    LogLikelihood L;
+    L.Value = s.LogIntensity - s.N * log(Norm);
+    L.FreeAmplitudes = Der.FreeAmplitudes;
+    L.FreeAmplitudeGradient.assign(Der.FreeAmplitudes.size(), 0.);
+
+    // derivatives of Norm with respect to real parameters
+    std::vector<double> dNorm(P, 0.);
+
+    if (hessian)
+        L.FreeAmplitudeHessian = s.Hessian;
+
+    for (size_t c = 0; c < M.components().size(); ++c) {
+        const auto& plan = *M.components()[c].amplitudePlan();
+        const auto& dtvi = MI.integrals()[c].Integral;
+        auto a = plan.dataIndependentAmplitudes();
+        auto adm = M.components()[c].admixture()->value();
+
+        // cached integral components: M_ij = integral of conj(A_i) * A_j
+        std::vector<std::vector<std::complex<double> > > Mij(a.size(), std::vector<std::complex<double> >(a.size()));
+        for (size_t i = 0; i < a.size(); ++i)
+            for (size_t j = 0; j < a.size(); ++j)
+                Mij[i][j] = dtvi.component(i, j).value();
+
+        for (size_t l = 0; l < a.size(); ++l) {
+
+            // derivative of log-likelihood with respect to a_cl,
+            // with d Norm / d a_cl = adm_c * sum_i conj(a_ci) * M_cil
+            std::complex<double> E = 0.;
+            for (size_t i = 0; i < a.size(); ++i)
+                E += conj(a[i]) * Mij[i][l];
+            auto W = s.Amplitudes[c][l] - r * adm * E;
+
+            for (const auto& f_da : Der.Trees[c][l].First) {
+                auto daW = f_da.second * W;
+                L.FreeAmplitudeGradient[f_da.first] += std::complex<double>(2. * real(daW), -2. * imag(daW));
+                auto daE = adm * f_da.second * E;
+                dNorm[2 * f_da.first] += 2. * real(daE);
+                dNorm[2 * f_da.first + 1] -= 2. * imag(daE);
+            }
+
+            if (!hessian)
+                continue;
+
+            // second derivatives of a_cl, with d^2 a / dRe dIm = i * a'' and d^2 a / dIm dIm = -a''
+            for (const auto& fg_d2a : Der.Trees[c][l].Second) {
+                auto f = std::get<0>(fg_d2a);
+                auto g = std::get<1>(fg_d2a);
+                auto d2aW = std::get<2>(fg_d2a) * W;
+                const double h[2][2] = {{2. * real(d2aW), -2. * imag(d2aW)}, {-2. * imag(d2aW), -2. * real(d2aW)}};
+                for (unsigned u = 0; u < 2; ++u)
+                    for (unsigned v = 0; v < 2; ++v) {
+                        auto p = 2 * f + u;
+                        auto q = 2 * g + v;
+                        // upper triangle only
+                        if (p <= q)
+                            L.FreeAmplitudeHessian[p][q] += h[u][v];
+                        else if (f != g)
+                            L.FreeAmplitudeHessian[q][p] += h[u][v];
+                    }
+            }
+        }
+
+        if (hessian) {
+            // derivatives of a_c with respect to real parameters
+            std::vector<std::vector<std::complex<double> > > da(P, std::vector<std::complex<double> >(a.size(), 0.));
+            for (size_t l = 0; l < a.size(); ++l)
+                for (const auto& f_da : Der.Trees[c][l].First) {
+                    da[2 * f_da.first][l] = f_da.second;
+                    da[2 * f_da.first + 1][l] = std::complex<double>(0, 1) * f_da.second;
+                }
+
+            // -N / Norm * adm_c * 2 Re(sum_ij conj(da_i/dq) * M_ij * da_j/dp)
+            for (size_t p = 0; p < P; ++p) {
+                std::vector<std::complex<double> > Mda(a.size(), 0.);
+                for (size_t i = 0; i < a.size(); ++i)
+                    for (size_t j = 0; j < a.size(); ++j)
+                        Mda[i] += Mij[i][j] * da[p][j];
+                for (size_t q = p; q < P; ++q) {
+                    std::complex<double> t = 0.;
+                    for (size_t i = 0; i < a.size(); ++i)
+                        t += conj(da[q][i]) * Mda[i];
+                    L.FreeAmplitudeHessian[p][q] -= r * adm * 2. * real(t);
+                }
+            }
+        }
+
+        if (M.components()[c].admixture()->variableStatus() != VariableStatus::fixed) {
+            L.Admixtures.push_back(M.components()[c].admixture());
+            L.AdmixtureGradient.push_back(s.Admixtures[c] - r * integral(dtvi).value());
+        }
+    }
+
+    if (hessian) {
+        // N / Norm^2 * dNorm/dp * dNorm/dq, and fill lower triangle
+        for (size_t p = 0; p < P; ++p)
+            for (size_t q = p; q < P; ++q) {
+                L.FreeAmplitudeHessian[p][q] += r / Norm * dNorm[p] * dNorm[q];
+                L.FreeAmplitudeHessian[q][p] = L.FreeAmplitudeHessian[p][q];
+            }
+    }
+
+    return L;
+}
+
+//-------------------------
+const LogLikelihood calculate(const Model& M, DataPartition& D, const ModelIntegral& MI, bool hessian, unsigned n_threads)
+{
+    check(M, MI, hessian ? "log_likelihood_hessian" : "log_likelihood");
+    auto Der = derivatives(M, hessian);
+    return combine(M, MI, Der, data_sums(M, D, Der, hessian, n_threads), hessian);
+}
+
+//-------------------------
+const LogLikelihood calculate(const Model& M, DataPartitionVector& DP, const ModelIntegral& MI, bool hessian)
+{
+    std::string func = hessian ? "log_likelihood_hessian" : "log_likelihood";
+
+    if (DP.empty())
+        throw exceptions::Exception("DataPartitionVector is empty", func);
+
+    if (std::any_of(DP.begin(), DP.end(), std::logical_not<DataPartitionVector::value_type>()))
+        throw exceptions::Exception("DataPartitionVector contains nullptr", func);
+
+    check(M, MI, func);
+
+    auto Der = derivatives(M, hessian);
+
+    // create thread for calculation on each partition
+    std::vector<std::future<DataSums> > partial_sums;
+    partial_sums.reserve(DP.size());
+    for (auto& P : DP)
+        partial_sums.push_back(std::async(std::launch::async, data_sums, std::cref(M), std::ref(*P), std::cref(Der), hessian, 1));
+
+    DataSums s(M, hessian ? Der.nParameters() : 0);
+    for (auto& ps : partial_sums)
+        s += ps.get();
+
+    return combine(M, MI, Der, s, hessian);
+}
+
+}
+
+//-------------------------
+const LogLikelihood log_likelihood(const Model& M, DataPartition& D, const ModelIntegral& MI, unsigned n_threads)
+{
+    return calculate(M, D, MI, false, n_threads);
+}
+
+//-------------------------
+const LogLikelihood log_likelihood(const Model& M, DataPartitionVector& DP, const ModelIntegral& MI)
+{
+    return calculate(M, DP, MI, false);
+}
+
+//-------------------------
+const LogLikelihood log_likelihood_hessian(const Model& M, DataPartition& D, const ModelIntegral& MI, unsigned n_threads)
+{
+    return calculate(M, D, MI, true, n_threads);
+}
+
+//-------------------------
+const LogLikelihood log_likelihood_hessian(const Model& M, DataPartitionVector& DP, const ModelIntegral& MI)
+{
+    return calculate(M, DP, MI, true);
+}
+
+}
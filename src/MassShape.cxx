@@ -1,20 +1,39 @@
 #include "MassShape.h"
 
+#include "AmplitudePlan.h"
 #include "CachedValue.h"
 #include "CalculationStatus.h"
 #include "DataPartition.h"
 #include "DecayingParticle.h"
 #include "Exceptions.h"
+#include "FourMomenta.h"
 #include "logging.h"
+#include "Model.h"
 #include "Parameter.h"
 #include "ParticleCombination.h"
 #include "VariableStatus.h"
 
+#include <algorithm>
+
 namespace yap {
 
+//-------------------------
+MassShapeBatch::MassShapeBatch(size_t n_daughters) :
+    Size(0),
+    M(MassShape::batch_size),
+    M2(MassShape::batch_size),
+    DaughterM(n_daughters, std::vector<double>(MassShape::batch_size)),
+    T(MassShape::batch_size)
+{
+}
+
+//-------------------------
+constexpr size_t MassShape::batch_size;
+
 //-------------------------
 MassShape::MassShape() :
     RecalculableAmplitudeComponent(equal_by_orderless_content),
+    T_(ComplexCachedValue::create(*this)),
     Owner_(nullptr)
 {}
 
@@ -26,6 +45,57 @@ void MassShape::calculate(DataPartition& D) const
         calculate(D, pc_si.first, pc_si.second);
 }
 
+//-------------------------
+void MassShape::calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const
+{
+    // if no calculation necessary, exit
+    if (D.status(*T_, si) != CalculationStatus::uncalculated)
+        return;
+
+    MassShapeBatch B(requiresDaughterMasses() ? pc->daughters().size() : 0);
+
+    const auto& fm = *model()->fourMomenta();
+
+    for (auto first = D.begin(); first != D.end(); first += B.Size) {
+
+        B.Size = std::min<size_t>(batch_size, D.end() - first);
+
+        // gather masses
+        fm.m(first, B.Size, pc, B.M.data());
+        for (size_t i = 0; i < B.Size; ++i)
+            B.M2[i] = B.M[i] * B.M[i];
+        for (size_t j = 0; j < B.DaughterM.size(); ++j)
+            fm.m(first, B.Size, pc->daughters()[j], B.DaughterM[j].data());
+
+        calculateT(B, first, pc);
+
+        // store amplitudes
+        auto it = first;
+        for (size_t i = 0; i < B.Size; ++i, ++it)
+            T_->setValue(B.T[i], *it, si, D);
+    }
+
+    D.status(*T_, si) = CalculationStatus::calculated;
+}
+
+//-------------------------
+void MassShape::updateCalculationStatus(StatusManager& D) const
+{
+    D.set(*T_, CalculationStatus::uncalculated);
+}
+
+//-------------------------
+const std::complex<double> MassShape::value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    return T_->value(d, symmetrizationIndex(pc));
+}
+
+//-------------------------
+AmplitudeFactor MassShape::factor(const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    return AmplitudeFactor(*T_, symmetrizationIndex(pc));
+}
+
 //-------------------------
 bool MassShape::consistent() const
 {
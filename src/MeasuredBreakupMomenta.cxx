@@ -1,10 +1,14 @@
 #include "MeasuredBreakupMomenta.h"
 
+#include "CachedValue.h"
+#include "CalculationStatus.h"
+#include "DataPartition.h"
 #include "DataPoint.h"
 #include "Exceptions.h"
 #include "FourMomenta.h"
 #include "Model.h"
 #include "ParticleCombination.h"
+#include "StatusManager.h"
 
 namespace yap {
 
@@ -17,9 +21,7 @@ double q2(const DataPoint& d, const std::shared_ptr<const ParticleCombination>&
         throw exceptions::Exception("invalid number of daughters (" + std::to_string(pc->daughters().size()) + ")",
                                     "measured_breakup_momenta::q2");
 
-    return q2(m.fourMomenta()->m2(d, pc),
-        m.fourMomenta()->m(d, pc->daughters()[0]),
-        m.fourMomenta()->m(d, pc->daughters()[1]));
+    return m.measuredBreakupMomenta()->q2(d, pc);
 }
 
 //-------------------------
@@ -34,4 +36,72 @@ double q2(double m2_R, double m_a, double m_b)
 
 }
 
+//-------------------------
+MeasuredBreakupMomenta::MeasuredBreakupMomenta(Model& m) :
+    StaticDataAccessor(m, equal_down_by_orderless_content),
+    Q2_(RealCachedValue::create(*this)),
+    Q_(RealCachedValue::create(*this))
+{
+    registerWithModel();
+}
+
+//-------------------------
+void MeasuredBreakupMomenta::addParticleCombination(const ParticleCombination& pc)
+{
+    if (pc.daughters().size() == 2)
+        StaticDataAccessor::addParticleCombination(pc);
+}
+
+//-------------------------
+double MeasuredBreakupMomenta::q2(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    return Q2_->value(d, symmetrizationIndex(pc));
+}
+
+//-------------------------
+double MeasuredBreakupMomenta::q(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
+{
+    return Q_->value(d, symmetrizationIndex(pc));
+}
+
+//-------------------------
+void MeasuredBreakupMomenta::q2(DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc, double* q2) const
+{
+    auto si = symmetrizationIndex(pc);
+    for (size_t i = 0; i < n; ++i, ++first)
+        q2[i] = Q2_->value(*first, si);
+}
+
+//-------------------------
+void MeasuredBreakupMomenta::q(DataIterator first, size_t n, const std::shared_ptr<const ParticleCombination>& pc, double* q) const
+{
+    auto si = symmetrizationIndex(pc);
+    for (size_t i = 0; i < n; ++i, ++first)
+        q[i] = Q_->value(*first, si);
+}
+
+//-------------------------
+void MeasuredBreakupMomenta::calculate(DataPoint& d, StatusManager& sm) const
+{
+    // set all breakup momenta as uncalculated
+    sm.set(*Q2_, CalculationStatus::uncalculated);
+    sm.set(*Q_, CalculationStatus::uncalculated);
+
+    const auto& fm = *model()->fourMomenta();
+
+    for (auto& kv : symmetrizationIndices()) {
+
+        // check if calculation unnecessary
+        if (sm.status(*Q2_, kv.second) == CalculationStatus::calculated)
+            continue;
+
+        auto q2 = measured_breakup_momenta::q2(fm.m2(d, kv.first),
+                                               fm.m(d, kv.first->daughters()[0]),
+                                               fm.m(d, kv.first->daughters()[1]));
+
+        Q2_->setValue(q2, d, kv.second, sm);
+        Q_->setValue(sqrt(q2), d, kv.second, sm);
+    }
+}
+
 }
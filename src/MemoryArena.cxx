@@ -0,0 +1,80 @@
+#include "MemoryArena.h"
+
+#include "Exceptions.h"
+
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+namespace yap {
+
+//-------------------------
+MemoryArena::MemoryArena(size_t bytes, bool huge_pages) :
+    Begin_(nullptr),
+    Size_(bytes),
+    Top_(nullptr)
+{
+    if (Size_ == 0)
+        throw exceptions::Exception("zero size", "MemoryArena::MemoryArena");
+
+#ifdef MAP_NORESERVE
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+#else
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#endif
+
+    void* p = mmap(nullptr, Size_, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+
+    Begin_ = static_cast<char*>(p);
+    Top_ = Begin_;
+
+#ifdef MADV_HUGEPAGE
+    // only a hint: failure leaves normal pages in place
+    if (huge_pages)
+        madvise(Begin_, Size_, MADV_HUGEPAGE);
+#else
+    (void)huge_pages;
+#endif
+}
+
+//-------------------------
+MemoryArena::~MemoryArena()
+{
+    munmap(Begin_, Size_);
+}
+
+//-------------------------
+void* MemoryArena::allocate(size_t bytes, size_t alignment)
+{
+    std::lock_guard<std::mutex> guard(Mutex_);
+
+    auto top = reinterpret_cast<std::uintptr_t>(Top_);
+    auto p = (top + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+
+    if (p + bytes > reinterpret_cast<std::uintptr_t>(Begin_ + Size_))
+        return nullptr;
+
+    Top_ = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+//-------------------------
+void MemoryArena::deallocate(void* p, size_t bytes)
+{
+    std::lock_guard<std::mutex> guard(Mutex_);
+
+    if (static_cast<char*>(p) + bytes == Top_)
+        Top_ = static_cast<char*>(p);
+}
+
+//-------------------------
+void MemoryArena::adviseSequential()
+{
+#ifdef MADV_SEQUENTIAL
+    madvise(Begin_, Size_, MADV_SEQUENTIAL);
+#endif
+}
+
+}
@@ -0,0 +1,335 @@
+#include "Minimizer.h"
+
+#include "Exceptions.h"
+#include "FreeAmplitude.h"
+#include "ImportanceSampler.h"
+#include "IntegralElement.h"
+#include "LogLikelihood.h"
+#include "Model.h"
+#include "ModelIntegral.h"
+#include "Parameter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <numeric>
+
+namespace yap {
+
+namespace {
+
+//-------------------------
+double dot(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return std::inner_product(a.begin(), a.end(), b.begin(), 0.);
+}
+
+//-------------------------
+// project x onto box [low, high]
+std::vector<double> project(std::vector<double> x, const std::vector<double>& low, const std::vector<double>& high)
+{
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = std::min(std::max(x[i], low[i]), high[i]);
+    return x;
+}
+
+//-------------------------
+// whether component i is held at a bound by the gradient
+bool at_bound(size_t i, const std::vector<double>& x, const std::vector<double>& g,
+              const std::vector<double>& low, const std::vector<double>& high)
+{
+    return (x[i] <= low[i] and g[i] > 0) or (x[i] >= high[i] and g[i] < 0);
+}
+
+}
+
+//-------------------------
+Minimizer::Minimizer(Model& M, DataPartitionVector fit_partitions, ModelIntegral& MI,
+                     DataPartitionVector integration_partitions) :
+    Model_(&M),
+    FitPartitions_(fit_partitions),
+    Integral_(&MI),
+    IntegrationPartitions_(integration_partitions),
+    MaxIterations_(1000),
+    HistorySize_(10),
+    GradientTolerance_(1.e-5),
+    RelativeTolerance_(1.e-12),
+    FiniteDifferenceStep_(1.e-5),
+    Iterations_(0),
+    LikelihoodCalls_(0),
+    Converged_(false)
+{
+    if (!Model_->locked())
+        throw exceptions::Exception("Model is not locked", "Minimizer::Minimizer");
+    if (FitPartitions_.empty())
+        throw exceptions::Exception("DataPartitionVector is empty", "Minimizer::Minimizer");
+}
+
+//-------------------------
+void Minimizer::addParameter(std::shared_ptr<RealParameter> P, double low, double high)
+{
+    if (!P)
+        throw exceptions::Exception("Parameter is nullptr", "Minimizer::addParameter");
+    if (IntegrationPartitions_.empty())
+        throw exceptions::Exception("no integration partitions to recalculate integral with", "Minimizer::addParameter");
+    if (std::find(ShapeParameters_.begin(), ShapeParameters_.end(), P) != ShapeParameters_.end())
+        throw exceptions::Exception("trying to add parameter twice", "Minimizer::addParameter");
+    if (std::dynamic_pointer_cast<PositiveRealParameter>(P))
+        low = std::max(low, std::numeric_limits<double>::min());
+    else if (std::dynamic_pointer_cast<NonnegativeRealParameter>(P))
+        low = std::max(low, 0.);
+    if (low > high)
+        throw exceptions::Exception("lower bound above upper bound", "Minimizer::addParameter");
+
+    ShapeParameters_.push_back(P);
+    ShapeLow_.push_back(low);
+    ShapeHigh_.push_back(high);
+}
+
+//-------------------------
+void Minimizer::addParameter(std::shared_ptr<ComplexParameter> P)
+{
+    if (!P)
+        throw exceptions::Exception("Parameter is nullptr", "Minimizer::addParameter");
+    if (IntegrationPartitions_.empty())
+        throw exceptions::Exception("no integration partitions to recalculate integral with", "Minimizer::addParameter");
+    if (std::find(ShapeParameters_.begin(), ShapeParameters_.end(), P) != ShapeParameters_.end())
+        throw exceptions::Exception("trying to add parameter twice", "Minimizer::addParameter");
+
+    ShapeParameters_.push_back(P);
+    ShapeLow_.insert(ShapeLow_.end(), 2, -std::numeric_limits<double>::infinity());
+    ShapeHigh_.insert(ShapeHigh_.end(), 2, std::numeric_limits<double>::infinity());
+}
+
+//-------------------------
+void Minimizer::setValues(const std::vector<double>& x)
+{
+    size_t i = 0;
+    for (auto& fa : FreeAmplitudes_) {
+        *fa = std::complex<double>(x[i], x[i + 1]);
+        i += 2;
+    }
+    for (auto& adm : Admixtures_)
+        adm->setValue(x[i++]);
+    set_values(ShapeParameters_.begin(), ShapeParameters_.end(), x.begin() + i, x.end());
+
+    // recalculate integrals whose parameters have changed
+    if (!IntegrationPartitions_.empty())
+        ImportanceSampler::calculate(*Integral_, IntegrationPartitions_);
+}
+
+//-------------------------
+double Minimizer::evaluate(const std::vector<double>& x, std::vector<double>& g)
+{
+    setValues(x);
+
+    auto L = log_likelihood(*Model_, FitPartitions_, *Integral_);
+    ++LikelihoodCalls_;
+
+    size_t i = 0;
+    for (const auto& dL : L.FreeAmplitudeGradient) {
+        g[i++] = -real(dL);
+        g[i++] = -imag(dL);
+    }
+    for (const auto& dL : L.AdmixtureGradient)
+        g[i++] = -dL;
+
+    // central finite differences in shape parameters,
+    // one-sided where a bound is within a step
+    if (i < x.size()) {
+        auto nll = [&](const std::vector<double>& y) {
+            setValues(y);
+            ++LikelihoodCalls_;
+            return -sum_of_log_intensity(*Model_, FitPartitions_, log(integral(*Integral_).value()));
+        };
+
+        auto f = -L.Value;
+        auto y = x;
+        for (size_t j = i; j < x.size(); ++j) {
+            auto low = ShapeLow_[j - i];
+            auto high = ShapeHigh_[j - i];
+            auto h = FiniteDifferenceStep_ * std::max(1., std::abs(x[j]));
+
+            if (x[j] + h <= high and x[j] - h >= low) {
+                y[j] = x[j] + h;
+                auto up = nll(y);
+                y[j] = x[j] - h;
+                auto dn = nll(y);
+                g[j] = (up - dn) / 2. / h;
+            } else if (x[j] + h <= high) {
+                y[j] = x[j] + h;
+                g[j] = (nll(y) - f) / h;
+            } else {
+                y[j] = x[j] - h;
+                g[j] = (f - nll(y)) / h;
+            }
+            y[j] = x[j];
+        }
+
+        // restore values
+        setValues(x);
+    }
+
+    return -L.Value;
+}
+
+//-------------------------
+const double Minimizer::minimize()
+{
+    Iterations_ = 0;
+    LikelihoodCalls_ = 0;
+    Converged_ = false;
+
+    // bring integral up to date and find amplitude parameters
+    if (!IntegrationPartitions_.empty())
+        ImportanceSampler::calculate(*Integral_, IntegrationPartitions_);
+    auto L0 = log_likelihood(*Model_, FitPartitions_, *Integral_);
+    FreeAmplitudes_ = L0.FreeAmplitudes;
+    Admixtures_ = L0.Admixtures;
+
+    // starting values and bounds
+    std::vector<double> x, low, high;
+    for (const auto& fa : FreeAmplitudes_) {
+        x.push_back(real(fa->value()));
+        x.push_back(imag(fa->value()));
+    }
+    low.assign(x.size(), -std::numeric_limits<double>::infinity());
+    for (const auto& adm : Admixtures_) {
+        x.push_back(adm->value());
+        low.push_back(0.);
+    }
+    high.assign(x.size(), std::numeric_limits<double>::infinity());
+    for (const auto& p : ShapeParameters_) {
+        if (auto r = std::dynamic_pointer_cast<RealParameter>(p))
+            x.push_back(r->value());
+        else {
+            auto c = std::static_pointer_cast<ComplexParameter>(p);
+            x.push_back(real(c->value()));
+            x.push_back(imag(c->value()));
+        }
+    }
+    low.insert(low.end(), ShapeLow_.begin(), ShapeLow_.end());
+    high.insert(high.end(), ShapeHigh_.begin(), ShapeHigh_.end());
+    x = project(x, low, high);
+
+    const size_t n = x.size();
+    std::vector<double> g(n);
+    auto f = evaluate(x, g);
+
+    // stored corrections: differences of positions and of gradients
+    std::deque<std::vector<double> > S, Y;
+    std::deque<double> rho;
+
+    for (Iterations_ = 0; Iterations_ < MaxIterations_; ++Iterations_) {
+
+        // check projected gradient
+        double pg = 0;
+        for (size_t i = 0; i < n; ++i)
+            pg = std::max(pg, std::abs(std::min(std::max(x[i] - g[i], low[i]), high[i]) - x[i]));
+        if (pg <= GradientTolerance_) {
+            Converged_ = true;
+            break;
+        }
+
+        // quasi-Newton direction in parameters not held at bounds, by two-loop recursion
+        std::vector<double> d(g);
+        for (size_t i = 0; i < n; ++i)
+            if (at_bound(i, x, g, low, high))
+                d[i] = 0;
+        std::vector<double> alpha(S.size());
+        for (size_t k = S.size(); k-- > 0; ) {
+            alpha[k] = rho[k] * dot(S[k], d);
+            for (size_t i = 0; i < n; ++i)
+                d[i] -= alpha[k] * Y[k][i];
+        }
+        if (!S.empty()) {
+            auto gamma = dot(S.back(), Y.back()) / dot(Y.back(), Y.back());
+            for (auto& di : d)
+                di *= gamma;
+        }
+        for (size_t k = 0; k < S.size(); ++k) {
+            auto beta = rho[k] * dot(Y[k], d);
+            for (size_t i = 0; i < n; ++i)
+                d[i] += (alpha[k] - beta) * S[k][i];
+        }
+        for (size_t i = 0; i < n; ++i)
+            d[i] = at_bound(i, x, g, low, high) ? 0 : -d[i];
+
+        // fall back to steepest descent if not a descent direction
+        if (dot(d, g) >= 0) {
+            S.clear();
+            Y.clear();
+            rho.clear();
+            for (size_t i = 0; i < n; ++i)
+                d[i] = at_bound(i, x, g, low, high) ? 0 : -g[i];
+        }
+
+        // backtracking line search along projected path, with sufficient decrease
+        double t = S.empty() ? std::min(1., 1. / std::sqrt(dot(d, d))) : 1.;
+        std::vector<double> x_new, g_new(n);
+        double f_new = f;
+        bool accepted = false;
+        for (unsigned ls = 0; ls < 50 and !accepted; ++ls, t /= 2) {
+            x_new = x;
+            for (size_t i = 0; i < n; ++i)
+                x_new[i] += t * d[i];
+            x_new = project(x_new, low, high);
+
+            std::vector<double> s(n);
+            for (size_t i = 0; i < n; ++i)
+                s[i] = x_new[i] - x[i];
+            auto gs = dot(g, s);
+            if (gs >= 0)
+                break;
+
+            f_new = evaluate(x_new, g_new);
+            accepted = std::isfinite(f_new) and f_new <= f + 1.e-4 * gs;
+        }
+
+        if (!accepted) {
+            // retry with steepest descent, else give up
+            if (!S.empty()) {
+                S.clear();
+                Y.clear();
+                rho.clear();
+                continue;
+            }
+            break;
+        }
+
+        // store correction if curvature is positive
+        std::vector<double> s(n), y(n);
+        for (size_t i = 0; i < n; ++i) {
+            s[i] = x_new[i] - x[i];
+            y[i] = g_new[i] - g[i];
+        }
+        auto sy = dot(s, y);
+        if (sy > std::numeric_limits<double>::epsilon() * dot(y, y)) {
+            S.push_back(s);
+            Y.push_back(y);
+            rho.push_back(1. / sy);
+            if (S.size() > HistorySize_) {
+                S.pop_front();
+                Y.pop_front();
+                rho.pop_front();
+            }
+        }
+
+        auto df = f - f_new;
+        x = x_new;
+        g = g_new;
+        f = f_new;
+
+        if (df <= RelativeTolerance_ * std::max({std::abs(f), std::abs(f_new), 1.})) {
+            Converged_ = true;
+            break;
+        }
+    }
+
+    // leave model at values found
+    setValues(x);
+
+    return -f;
+}
+
+}
@@ -1,5 +1,7 @@
 #include "Model.h"
 
+#include "AmplitudeMatrix.h"
+#include "AmplitudePlan.h"
 #include "Attributes.h"
 #include "BlattWeisskopf.h"
 #include "CalculationStatus.h"
@@ -15,11 +17,14 @@
 #include "FreeAmplitude.h"
 #include "FourMomenta.h"
 #include "Group.h"
+#include "HelicityAngles.h"
 #include "logging.h"
 #include "MassAxes.h"
+#include "MeasuredBreakupMomenta.h"
 #include "Parameter.h"
 #include "RecalculableDataAccessor.h"
 #include "SpinAmplitudeCache.h"
+#include "StaticDataCache.h"
 #include "VariableStatus.h"
 
 /// \todo Find better place for this
@@ -45,7 +50,8 @@ ModelComponent::ModelComponent(const DecayTreeVector& dtv, double adm) :
 Model::Model(std::unique_ptr<SpinAmplitudeCache> SAC) :
     Locked_(false),
     FourMomenta_(std::make_shared<FourMomenta>(*this)),
-    HelicityAngles_(*this)
+    MeasuredBreakupMomenta_(std::make_shared<MeasuredBreakupMomenta>(*this)),
+    HelicityAngles_(std::make_shared<HelicityAngles>(*this))
 {
     if (!SAC)
         throw exceptions::Exception("SpinAmplitudeCache unset", "Model::Model");
@@ -61,21 +67,27 @@ Model::Model(std::unique_ptr<SpinAmplitudeCache> SAC) :
 }
 
 //-------------------------
-void Model::calculate(DataPartition& D) const
+void Model::calculate(DataPartition& D, unsigned n_threads) const
 {
-    // update calculation statuses
-    for (const auto& rda : RecalculableDataAccessors_)
-        rda->updateCalculationStatus(D);
+    if (!locked())
+        throw exceptions::Exception("Model is not locked", "Model::calculate");
 
-    // call calculate on all RecalculableDataAccessors
+    // mark for recalculation the values of accessors whose parameters
+    // have changed since they were last calculated in D
     for (const auto& rda : RecalculableDataAccessors_)
-        rda->calculate(D);
+        if (rda->index() >= 0 && D.generation(*rda) != rda->generation()) {
+            rda->updateCalculationStatus(D);
+            D.generation(*rda) = rda->generation();
+        }
+
+    // call calculate on all RecalculableDataAccessors, after those they depend on
+    CalculationGraph_.calculate(D, n_threads);
 }
 
 //-------------------------
 const double intensity(const ModelComponent& c, const DataPoint& d)
 {
-    return c.admixture()->value() * intensity(c.decayTrees(), d);
+    return c.admixture()->value() * norm(c.amplitudePlan()->amplitude(d));
 }
 
 //-------------------------
@@ -89,29 +101,84 @@ const double intensity(const std::vector<ModelComponent>& C, const DataPoint& d)
 //-------------------------
 // hidden helper function,
 // resolves C++ problem related to naming of functions and call to std::async below
-const double sum_of_logs_of_intensities(const Model& M, DataPartition& D, double ped)
+const double sum_of_logs_of_intensities(const Model& M, DataPartition& D, double ped, unsigned n_threads)
 {
     // calculate components
-    M.calculate(D);
+    M.calculate(D, n_threads);
+
+    // data-independent amplitudes and admixtures, evaluated once for all data points
+    std::vector<std::vector<std::complex<double> > > A;
+    std::vector<double> adm;
+    A.reserve(M.components().size());
+    adm.reserve(M.components().size());
+    for (const auto& c : M.components()) {
+        A.push_back(c.amplitudePlan()->dataIndependentAmplitudes());
+        adm.push_back(c.admixture()->value());
+    }
+
+    auto I = [&](const DataPoint& d) {
+        double I = 0;
+        for (size_t i = 0; i < A.size(); ++i)
+            I += adm[i] * norm(M.components()[i].amplitudePlan()->amplitude(d, A[i]));
+        return I;
+    };
 
     // if pedestal is zero
     if (ped == 0)
         return std::accumulate(D.begin(), D.end(), CompensatedSum<double>(0.),
                                [&](CompensatedSum<double>& l, const DataPoint& d)
-                               {return l += log(intensity(M, d));});
+                               {return l += log(I(d));});
     // else
     return std::accumulate(D.begin(), D.end(), CompensatedSum<double>(0.),
                            [&](CompensatedSum<double>& l, const DataPoint& d)
-                           {return l += (log(intensity(M, d)) - ped);});
+                           {return l += (log(I(d)) - ped);});
 }
 
 //-------------------------
-const double sum_of_log_intensity(const Model& M, DataPartition& D, double ped)
+const double sum_of_log_intensity(const Model& M, DataPartition& D, double ped, unsigned n_threads)
 {
     if (M.components().empty())
         throw exceptions::Exception("Model has no components", "sum_of_log_intensity");
 
-    return sum_of_logs_of_intensities(M, D, ped);
+    return sum_of_logs_of_intensities(M, D, ped, n_threads);
+}
+
+//-------------------------
+const double sum_of_log_intensity(const Model& M, AmplitudeMatrix& A, double ped, unsigned n_threads)
+{
+    if (&A.model() != &M)
+        throw exceptions::Exception("AmplitudeMatrix is not of Model", "sum_of_log_intensity");
+
+    A.update(n_threads);
+
+    // intensities of data points
+    std::vector<double> I(A.rows(), 0.);
+
+    // amplitudes of data points, split into real and imaginary parts
+    // so that loops over columns need no complex multiplication
+    std::vector<double> re(A.rows()), im(A.rows());
+
+    for (size_t c = 0; c < M.components().size(); ++c) {
+        auto a = M.components()[c].amplitudePlan()->dataIndependentAmplitudes();
+
+        std::fill(re.begin(), re.end(), 0.);
+        std::fill(im.begin(), im.end(), 0.);
+        for (size_t k = 0; k < a.size(); ++k) {
+            const auto& col = A.column(c, k);
+            for (size_t i = 0; i < col.size(); ++i) {
+                re[i] += real(a[k]) * real(col[i]) - imag(a[k]) * imag(col[i]);
+                im[i] += real(a[k]) * imag(col[i]) + imag(a[k]) * real(col[i]);
+            }
+        }
+
+        auto adm = M.components()[c].admixture()->value();
+        for (size_t i = 0; i < I.size(); ++i)
+            I[i] += adm * (re[i] * re[i] + im[i] * im[i]);
+    }
+
+    return std::accumulate(I.begin(), I.end(), CompensatedSum<double>(0.),
+                           [ped](CompensatedSum<double>& l, double i)
+                           {return l += (log(i) - ped);});
 }
 
 //-------------------------
@@ -138,13 +205,67 @@ const double sum_of_log_intensity(const Model& M, DataPartitionVector& DP, doubl
     // create thread for calculation on each partition
     for (auto& P : DP)
         // since std::async copies its arguments, even if they are supposed to be references, we need to use std::ref and std::cref
-        partial_sums.push_back(std::async(std::launch::async, sum_of_logs_of_intensities, std::cref(M), std::ref(*P), ped));
+        partial_sums.push_back(std::async(std::launch::async, sum_of_logs_of_intensities, std::cref(M), std::ref(*P), ped, 1));
 
     // wait for each partition to finish calculating
     return std::accumulate(partial_sums.begin(), partial_sums.end(), 0.,
                            [](double& l, std::future<double>& s) {return l += s.get();});
 }
 
+//-------------------------
+const double sum_of_log_intensity(const Model& M, std::shared_ptr<StaticDataCache> cache, size_t chunk_size,
+                                  unsigned n_partitions, double ped)
+{
+    if (!cache)
+        throw exceptions::Exception("StaticDataCache is empty", "sum_of_log_intensity");
+
+    if (chunk_size == 0)
+        throw exceptions::Exception("chunk size is zero", "sum_of_log_intensity");
+
+    if (M.components().empty())
+        throw exceptions::Exception("Model has no components", "sum_of_log_intensity");
+
+    // holds one chunk at a time; only its non-static columns occupy memory of its own
+    DataSet D(M, cache->precision());
+    auto N = cache->size();
+
+    // partitions of current chunk, created anew for each chunk so their statuses start uncalculated
+    DataPartitionVector DP;
+    auto delete_partitions = [&DP]() { for (auto& P : DP) delete P; DP.clear(); };
+
+    // read first chunk
+    auto next = std::async(std::launch::async, &StaticDataCache::prefetch, cache.get(), 0, std::min(chunk_size, N));
+
+    CompensatedSum<double> L(0.);
+
+    try {
+        for (size_t first = 0; first < N; first += chunk_size) {
+            auto last = std::min(first + chunk_size, N);
+
+            // wait for chunk to be read, and start reading the next one
+            next.get();
+            next = std::async(std::launch::async, &StaticDataCache::prefetch, cache.get(), last, std::min(last + chunk_size, N));
+
+            D.map(cache, first, last);
+
+            if (n_partitions > 1) {
+                DP = DataPartitionBlock::create(D, n_partitions);
+                L += sum_of_log_intensity(M, DP, ped);
+                delete_partitions();
+            } else
+                L += sum_of_log_intensity(M, D, ped);
+
+            cache->release(first, last);
+        }
+        next.get();
+    } catch (...) {
+        delete_partitions();
+        throw;
+    }
+
+    return L;
+}
+
 //-------------------------
 bool Model::consistent() const
 {
@@ -173,6 +294,7 @@ void Model::addParticleCombination(const ParticleCombination& pc)
         return;
 
     FourMomenta_->addParticleCombination(pc);
+    MeasuredBreakupMomenta_->addParticleCombination(pc);
 
     // call recursively on daughters
     for (auto& d : pc.daughters())
@@ -215,8 +337,6 @@ void Model::setFinalStateMomenta(DataPoint& d, const std::vector<FourVector<doub
     // call calculate on all static data accessors in model
     for (const auto& sda : StaticDataAccessors_)
         sda->calculate(d, sm);
- 
-    HelicityAngles_.clearCache(sm);
 }
 
 //-------------------------
@@ -337,6 +457,12 @@ void Model::lock()
     for (auto& D : DataAccessors_)
         D->pruneSymmetrizationIndices();
 
+    // assign dense indices to particle combinations,
+    // and tabulate DataAccessor's symmetrization indices by them
+    auto n_pc = ParticleCombinationCache_.setIndices();
+    for (auto& D : DataAccessors_)
+        D->tabulateSymmetrizationIndices(n_pc);
+
     // remove data accessors from list that don't need storage
     for (auto it = DataAccessors_.begin(); it != DataAccessors_.end(); ) {
         if (!(*it)->requiresStorage())
@@ -345,10 +471,25 @@ void Model::lock()
             ++it;
     }
 
-    // set DataAccessor indices
+    // set DataAccessor indices, positions of statuses in StatusManager's,
+    // and positions of columns in DataColumns
     int index = -1;
-    for (const auto& da : DataAccessors_)
+    unsigned status_offset = 0;
+    unsigned column_offset = 0;
+    for (const auto& da : DataAccessors_) {
         da->setIndex(++index);
+        da->setStatusOffset(status_offset);
+        status_offset += da->nStatuses();
+        da->setColumnOffset(column_offset);
+        column_offset += da->nSymmetrizationIndices() * da->size();
+    }
+
+    // order RecalculableDataAccessor's by their dependencies
+    CalculationGraph_ = CalculationGraph(RecalculableDataAccessors_);
+
+    // compile amplitude evaluation plans, now that DataAccessor indices are set
+    for (auto& c : Components_)
+        c.AmplitudePlan_ = std::make_shared<AmplitudePlan>(c.decayTrees());
 
     Locked_ = true;
 }
@@ -422,7 +563,7 @@ const MassAxes Model::massAxes(std::vector<std::vector<unsigned> > pcs) const
 }
 
 //-------------------------
-DataSet Model::createDataSet(size_t n)
+DataSet Model::createDataSet(size_t n, StoragePrecision precision, std::shared_ptr<MemoryArena> arena)
 {
     if (!locked())
         lock();
@@ -431,7 +572,7 @@ DataSet Model::createDataSet(size_t n)
         throw exceptions::Exception("data sets cannot be generated from an unlocked model.", "Model::createDataSet");
 
     // create empty data set
-    DataSet D(*this);
+    DataSet D(*this, precision, arena);
 
     D.addEmptyDataPoints(n);
 
@@ -1,27 +1,22 @@
 #include "NonrelativisticBreitWigner.h"
 
 #include "BlattWeisskopf.h"
-#include "CachedValue.h"
-#include "CalculationStatus.h"
 #include "DataPartition.h"
 #include "DecayChannel.h"
 #include "DecayingParticle.h"
-#include "FourMomenta.h"
 #include "logging.h"
 #include "MathUtilities.h"
 #include "MeasuredBreakupMomenta.h"
 #include "Model.h"
 #include "Parameter.h"
 
+#include <array>
+
 namespace yap {
 
 //-------------------------
-void NonrelativisticBreitWigner::calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const
+void NonrelativisticBreitWigner::calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const
 {
-    // if no calculation necessary, exit
-    if (D.status(*T(), si) != CalculationStatus::uncalculated)
-        return;
-
     /////////////////////////
     // common factors:
 
@@ -31,7 +26,7 @@ void NonrelativisticBreitWigner::calculate(DataPartition& D, const std::shared_p
     // squared resonance mass
     double m2_R = pow(mass()->value(), 2);
 
-    // i * nominal mass * nominal width
+    // nominal mass * nominal width
     auto mw_R = mass()->value() * width()->value();
 
     // J + 1/2
@@ -39,33 +34,36 @@ void NonrelativisticBreitWigner::calculate(DataPartition& D, const std::shared_p
 
     /////////////////////////
 
-    // calculate BlattWeisskopf
-    blattWeisskopf()->calculate(D);
+    // squared barrier factors
+    std::array<double, batch_size> F2;
+    squaredBarrierFactors(F2.data(), first, B.Size, pc);
 
-    // T := 1 / (M^2 - m^2 - i * M * Gamma)
-    for (auto& d : D) {
+    const auto& m_a = B.DaughterM[0];
+    const auto& m_b = B.DaughterM[1];
 
-        // retrieve masses
-        double m_ab = model()->fourMomenta()->m(d, pc);
-        double m2_ab = m_ab * m_ab;
-        double m_a  = model()->fourMomenta()->m(d, pc->daughters()[0]);
-        double m_b  = model()->fourMomenta()->m(d, pc->daughters()[1]);
+    // measured breakup momenta
+    std::array<double, batch_size> q_meas;
+    model()->measuredBreakupMomenta()->q(first, B.Size, pc, q_meas.data());
 
-        // calculate nominal breakup momentum
-        double q2_nomi = measured_breakup_momenta::q2(m2_R, m_a, m_b);
+    // squared nominal breakup momenta and squared barrier factors at them
+    std::array<double, batch_size> q2_nomi;
+    std::array<double, batch_size> z_nomi;
+    for (size_t i = 0; i < B.Size; ++i) {
+        q2_nomi[i] = measured_breakup_momenta::q2(m2_R, m_a[i], m_b[i]);
+        z_nomi[i] = q2_nomi[i] * r2;
+    }
+    std::array<double, batch_size> F2_nomi;
+    squared_barrier_factors(blattWeisskopf()->L(), F2_nomi.data(), z_nomi.data(), B.Size);
 
-        // retrieve measured breakup momentum
-        double q2_meas = measured_breakup_momenta::q2(m2_ab, m_a, m_b);
+    // T := 1 / (M - m - i * Gamma / 2)
+    for (size_t i = 0; i < B.Size; ++i) {
 
-        double Q = sqrt(q2_meas / q2_nomi);
-        
-        auto w =  0.5 * mw_R / m_ab * pow(Q, twoLp1) * pow(blattWeisskopf()->value(d, pc), 2) / squared_barrier_factor(blattWeisskopf()->L(), q2_nomi * r2);
+        double Q = q_meas[i] / sqrt(q2_nomi[i]);
 
-        T()->setValue(w / (mass()->value() - m_ab - 1_i * w), d, si, D);
+        auto w = 0.5 * mw_R / B.M[i] * pow(Q, twoLp1) * F2[i] / F2_nomi[i];
 
+        B.T[i] = w / (mass()->value() - B.M[i] - 1_i * w);
     }
-
-    D.status(*T(), si) = CalculationStatus::calculated;
 }
 
 }
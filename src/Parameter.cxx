@@ -0,0 +1,15 @@
+#include "Parameter.h"
+
+#include "RecalculableDataAccessor.h"
+
+namespace yap {
+
+//-------------------------
+void ParameterBase::notifySubscribers()
+{
+    ++Generation_;
+    for (auto& rda : Subscribers_)
+        rda->parameterChanged();
+}
+
+}
@@ -50,6 +50,18 @@ void ParticleCombinationCache::addToCache(shared_ptr_type pc)
     // setLineage(pc);
 }
 
+//-------------------------
+unsigned ParticleCombinationCache::setIndices()
+{
+    unsigned n = 0;
+    for (auto& wpc : *this) {
+        if (wpc.expired())
+            continue;
+        const_cast<ParticleCombination&>(*wpc.lock()).Index_ = n++;
+    }
+    return n;
+}
+
 //-------------------------
 bool ParticleCombinationCache::consistent() const
 {
@@ -1,10 +1,7 @@
 #include "PoleMass.h"
 
-#include "CalculationStatus.h"
 #include "DataPartition.h"
-#include "FourMomenta.h"
 #include "logging.h"
-#include "Model.h"
 #include "Parameter.h"
 #include "ParticleTable.h"
 
@@ -13,7 +10,6 @@ namespace yap {
 //-------------------------
 PoleMass::PoleMass(std::complex<double> mass) :
     MassShape(),
-    T_(ComplexCachedValue::create(*this)),
     Mass_(std::make_shared<ComplexParameter>(mass))
 {
     addParameter(Mass_);
@@ -26,25 +22,8 @@ PoleMass::PoleMass(const ParticleTableEntry& pde) :
 }
 
 //-------------------------
-void PoleMass::updateCalculationStatus(StatusManager& D) const
+void PoleMass::calculateT(MassShapeBatch& B, DataIterator first, const std::shared_ptr<const ParticleCombination>& pc) const
 {
-    if (status() == VariableStatus::changed)
-        D.set(*T_, CalculationStatus::uncalculated);
-}
-
-//-------------------------
-const std::complex<double> PoleMass::value(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc) const
-{
-    return T_->value(d, symmetrizationIndex(pc));
-}
-
-//-------------------------
-void PoleMass::calculate(DataPartition& D, const std::shared_ptr<const ParticleCombination>& pc, unsigned si) const
-{
-    // if no calculation necessary, exit
-    if (D.status(*T_, si) != CalculationStatus::uncalculated)
-        return;
-
     /////////////////////////
     // common factors:
 
@@ -57,10 +36,8 @@ void PoleMass::calculate(DataPartition& D, const std::shared_ptr<const ParticleC
     /////////////////////////
     
     // T := 2 re(mass) im(mass) / (mass^2 - s)
-    for (auto& d : D)
-        T_->setValue(two_re_im_m / (m2 - model()->fourMomenta()->m2(d, pc)), d, si, D);
-
-    D.status(*T_, si) = CalculationStatus::calculated;
+    for (size_t i = 0; i < B.Size; ++i)
+        B.T[i] = two_re_im_m / (m2 - B.M2[i]);
 }
 
 //-------------------------
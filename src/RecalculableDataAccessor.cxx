@@ -3,8 +3,24 @@
 #include "Model.h"
 #include "Parameter.h"
 
+#include <algorithm>
+
 namespace yap {
 
+//-------------------------
+RecalculableDataAccessor::~RecalculableDataAccessor()
+{
+    for (auto& p : Parameters_)
+        p->Subscribers_.erase(std::remove(p->Subscribers_.begin(), p->Subscribers_.end(), this), p->Subscribers_.end());
+}
+
+//-------------------------
+void RecalculableDataAccessor::addParameter(std::shared_ptr<ParameterBase> p)
+{
+    if (Parameters_.insert(p).second)
+        p->Subscribers_.push_back(this);
+}
+
 //-------------------------
 void RecalculableDataAccessor::setParameterFlagsToUnchanged()
 {
@@ -1,5 +1,6 @@
 #include "SpinAmplitude.h"
 
+#include "AmplitudePlan.h"
 #include "CachedValue.h"
 #include "CalculationStatus.h"
 #include "Exceptions.h"
@@ -33,21 +34,21 @@ void SpinAmplitude::calculate(DataPoint& d, StatusManager& sm) const
     // loop over particle combinations -> indices
     for (auto& pc_i : symmetrizationIndices()) {
 
-        // loop over mapping of parent spin projection to AmplitudeSubmap
-        for (auto& aM_kv : Amplitudes_) {
+        // loop over amplitudes
+        for (size_t i = 0; i < Amplitudes_.size(); ++i)
 
-            const auto& two_M = aM_kv.first; // parent spin projection
-
-            // loop over mappin of daughter spin projection pairs to amplitudes
-            for (auto& aSM_kv : aM_kv.second)
-
-                // if yet uncalculated
-                if (sm.status(*aSM_kv.second, pc_i.second) == CalculationStatus::uncalculated)
-                    aSM_kv.second->setValue(calc(two_M, aSM_kv.first, d, sm, pc_i.first), d, pc_i.second, sm);
-        }
+            // if yet uncalculated
+            if (sm.status(*Amplitudes_[i], pc_i.second) == CalculationStatus::uncalculated)
+                Amplitudes_[i]->setValue(calc(InitialTwoM_[i], FinalTwoM_[i], d, sm, pc_i.first), d, pc_i.second, sm);
     }
 }
 
+//-------------------------
+AmplitudeFactor SpinAmplitude::factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const
+{
+    return AmplitudeFactor(*Amplitudes_[i], symmetrizationIndex(pc));
+}
+
 //-------------------------
 SpinAmplitude::operator std::string() const
 {
@@ -60,8 +61,8 @@ SpinAmplitude::operator std::string() const
 const std::set<int> SpinAmplitude::twoM() const
 {
     std::set<int> S;
-    // loop over amplitudes, key = two_M
-    for (auto& kv : Amplitudes_)
+    // loop over amplitude indices, key = two_M
+    for (auto& kv : AmplitudeIndices_)
         S.insert(kv.first);  // first entry is (twice) parent spin projection
     return S;
 }
@@ -69,10 +70,10 @@ const std::set<int> SpinAmplitude::twoM() const
 //-------------------------
 const std::set<SpinProjectionVector> SpinAmplitude::twoM(int two_M) const
 {
-    auto it = Amplitudes_.find(two_M);
+    auto it = AmplitudeIndices_.find(two_M);
 
     // if two_M not found, return empty set
-    if (it == Amplitudes_.end())
+    if (it == AmplitudeIndices_.end())
         return std::set<SpinProjectionVector>();
 
     std::set<SpinProjectionVector> two_m;
@@ -82,20 +83,29 @@ const std::set<SpinProjectionVector> SpinAmplitude::twoM(int two_M) const
 }
 
 //-------------------------
-void SpinAmplitude::addAmplitude(int two_M, const SpinProjectionVector& two_m, bool store_null)
+const unsigned SpinAmplitude::addAmplitude(int two_M, const SpinProjectionVector& two_m, bool store_null, double bound)
 {
     // retrieve (or create) AmplitudeSubmap for two_M
-    auto& ASM = Amplitudes_[two_M];
+    auto& ASM = AmplitudeIndices_[two_M];
 
     // look for two_m in AmplitudeSubmap
     if (ASM.find(two_m) != ASM.end())
         throw exceptions::Exception("Amplitude already stored for " + spin_to_string(two_M) + " -> " + to_string(two_m),
                                     "SpinAmplitude::addAmplitude");
 
+    ASM[two_m] = Amplitudes_.size();
+    InitialTwoM_.push_back(two_M);
+    FinalTwoM_.push_back(two_m);
+
     if (store_null)
-        ASM[two_m] = std::shared_ptr<ComplexCachedValue>(nullptr);
-    else
-        ASM[two_m] = ComplexCachedValue::create(*this);
+        Amplitudes_.push_back(std::shared_ptr<ComplexCachedValue>(nullptr));
+    else {
+        // spin amplitudes are bounded angular functions and need no more than float precision
+        Amplitudes_.push_back(ComplexCachedValue::create(*this, StoragePrecision::single_precision));
+        Amplitudes_.back()->setBound(bound);
+    }
+
+    return ASM[two_m];
 }
 
 //-------------------------
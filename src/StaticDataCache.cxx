@@ -0,0 +1,313 @@
+#include "StaticDataCache.h"
+
+#include "CoordinateSystem.h"
+#include "DataAccessor.h"
+#include "DataColumns.h"
+#include "DataSet.h"
+#include "Exceptions.h"
+#include "Model.h"
+#include "ParticleCombination.h"
+#include "SpinAmplitude.h"
+#include "StaticDataAccessor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <typeinfo>
+#include <unistd.h>
+
+namespace yap {
+
+namespace {
+
+/// identifies file as StaticDataCache
+constexpr char magic[8] = {'Y', 'A', 'P', 'S', 'D', 'C', 0, 0};
+
+/// version of file format
+constexpr uint32_t version = 2;
+
+/// alignment of columns in file
+constexpr uint64_t alignment = 64;
+
+/// header of file, followed by one ColumnEntry per column
+struct Header {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t Precision;
+    uint64_t Key;
+    uint64_t Size;
+    uint64_t NColumns;
+};
+
+/// position and element width of column
+struct ColumnEntry {
+    uint64_t Offset;
+    uint64_t Width;
+};
+
+/// \return n rounded up to multiple of alignment
+constexpr uint64_t aligned(uint64_t n)
+{ return (n + alignment - 1) / alignment * alignment; }
+
+/// \return StaticDataAccessor's of Model that require storage, ordered by index
+std::vector<const DataAccessor*> static_data_accessors(const Model& M)
+{
+    std::vector<const DataAccessor*> S;
+    for (const auto& da : M.dataAccessors())
+        if (dynamic_cast<const StaticDataAccessor*>(da))
+            S.push_back(da);
+    std::sort(S.begin(), S.end(), [](const DataAccessor* A, const DataAccessor* B) {return A->index() < B->index();});
+    return S;
+}
+
+}
+
+//-------------------------
+StaticDataCache::StaticDataCache(const std::string& filename) :
+    Begin_(nullptr),
+    Bytes_(0),
+    Key_(0),
+    Precision_(StoragePrecision::double_precision),
+    Size_(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw exceptions::Exception("could not open " + filename, "StaticDataCache::StaticDataCache");
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 or static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        throw exceptions::Exception(filename + " is not a static data cache", "StaticDataCache::StaticDataCache");
+    }
+    Bytes_ = st.st_size;
+
+    // read-only mapping: pages are read on demand and never written
+    void* p = mmap(nullptr, Bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw exceptions::Exception("could not map " + filename, "StaticDataCache::StaticDataCache");
+    Begin_ = static_cast<char*>(p);
+
+    Header h;
+    std::memcpy(&h, Begin_, sizeof(Header));
+
+    if (std::memcmp(h.Magic, magic, sizeof(magic)) != 0 or h.Version != version
+            or h.Precision > static_cast<uint32_t>(StoragePrecision::double_precision)
+            or sizeof(Header) + h.NColumns * sizeof(ColumnEntry) > Bytes_) {
+        munmap(Begin_, Bytes_);
+        throw exceptions::Exception(filename + " is not a static data cache", "StaticDataCache::StaticDataCache");
+    }
+
+    Key_ = h.Key;
+    Precision_ = static_cast<StoragePrecision>(h.Precision);
+    Size_ = h.Size;
+    Offsets_.reserve(h.NColumns);
+    Widths_.reserve(h.NColumns);
+
+    for (uint64_t i = 0; i < h.NColumns; ++i) {
+        ColumnEntry c;
+        std::memcpy(&c, Begin_ + sizeof(Header) + i * sizeof(ColumnEntry), sizeof(ColumnEntry));
+        if (c.Offset % alignment != 0 or c.Offset > Bytes_ or c.Width * Size_ > Bytes_ - c.Offset) {
+            munmap(Begin_, Bytes_);
+            throw exceptions::Exception(filename + " is truncated", "StaticDataCache::StaticDataCache");
+        }
+        Offsets_.push_back(c.Offset);
+        Widths_.push_back(c.Width);
+    }
+}
+
+//-------------------------
+StaticDataCache::~StaticDataCache()
+{
+    munmap(Begin_, Bytes_);
+}
+
+//-------------------------
+void StaticDataCache::prefetch(size_t first, size_t last)
+{
+    if (first >= last)
+        return;
+
+    const uintptr_t page = sysconf(_SC_PAGESIZE);
+
+    for (size_t i = 0; i < nColumns(); ++i) {
+        // round outward to page boundaries
+        auto b = reinterpret_cast<uintptr_t>(Begin_ + Offsets_[i] + first * Widths_[i]) / page * page;
+        auto e = reinterpret_cast<uintptr_t>(Begin_ + Offsets_[i] + last * Widths_[i]);
+        madvise(reinterpret_cast<void*>(b), e - b, MADV_WILLNEED);
+
+        // touch every page, so that reading has finished on return
+        for (auto p = b; p < e; p += page)
+            (void)*reinterpret_cast<volatile const char*>(p);
+    }
+}
+
+//-------------------------
+void StaticDataCache::release(size_t first, size_t last)
+{
+    const uintptr_t page = sysconf(_SC_PAGESIZE);
+
+    for (size_t i = 0; i < nColumns(); ++i) {
+        // round inward to page boundaries, so as to not touch neighbouring data points
+        auto b = (reinterpret_cast<uintptr_t>(Begin_ + Offsets_[i] + first * Widths_[i]) + page - 1) / page * page;
+        auto e = reinterpret_cast<uintptr_t>(Begin_ + Offsets_[i] + last * Widths_[i]) / page * page;
+        if (b < e)
+            madvise(reinterpret_cast<void*>(b), e - b, MADV_DONTNEED);
+    }
+}
+
+//-------------------------
+std::vector<std::pair<unsigned, unsigned> > static_columns(const Model& M)
+{
+    std::vector<std::pair<unsigned, unsigned> > C;
+    for (const auto& da : static_data_accessors(M))
+        for (unsigned i = 0; i < da->nSymmetrizationIndices() * da->size(); ++i)
+            C.emplace_back(da->index(), i);
+    return C;
+}
+
+//-------------------------
+uint64_t static_data_key(const Model& M, StoragePrecision precision)
+{
+    if (!M.locked())
+        throw exceptions::Exception("Model is not locked", "static_data_key");
+
+    // describe everything the static columns depend on
+    std::string s = to_string(precision) + " precision; coordinates " + to_string(M.coordinateSystem());
+
+    DataColumns C(M.dataAccessors(), precision);
+
+    for (const auto& da : static_data_accessors(M)) {
+
+        auto sa = dynamic_cast<const SpinAmplitude*>(da);
+        s += "; " + (sa ? sa->formalism() + " " + to_string(*sa) : std::string(typeid(*da).name()));
+
+        // symmetrization indices, in an order independent of memory addresses
+        std::vector<std::string> sym;
+        for (const auto& kv : da->symmetrizationIndices())
+            sym.push_back(to_string_with_parent(*kv.first) + " = " + std::to_string(kv.second));
+        std::sort(sym.begin(), sym.end());
+        for (const auto& x : sym)
+            s += ", " + x;
+
+        for (unsigned i = 0; i < da->nSymmetrizationIndices() * da->size(); ++i)
+            s += " " + std::to_string(C.width(C.offset(da->index()) + i));
+    }
+
+    // 64-bit FNV-1a hash
+    uint64_t key = 14695981039346656037ull;
+    for (unsigned char c : s) {
+        key ^= c;
+        key *= 1099511628211ull;
+    }
+    return key;
+}
+
+//-------------------------
+StaticDataCacheWriter::StaticDataCacheWriter(const Model& M, StoragePrecision precision, size_t n, const std::string& filename) :
+    Model_(&M),
+    Precision_(precision),
+    Size_(n),
+    Written_(0),
+    Filename_(filename),
+    Columns_(static_columns(M))
+{
+    Header h;
+    std::memcpy(h.Magic, magic, sizeof(magic));
+    h.Version = version;
+    h.Precision = static_cast<uint32_t>(Precision_);
+    h.Key = static_data_key(M, Precision_);
+    h.Size = Size_;
+    h.NColumns = Columns_.size();
+
+    DataColumns C(M.dataAccessors(), Precision_);
+
+    std::vector<ColumnEntry> entries(Columns_.size());
+    Bytes_ = aligned(sizeof(Header) + entries.size() * sizeof(ColumnEntry));
+    for (size_t k = 0; k < Columns_.size(); ++k) {
+        entries[k].Offset = Bytes_;
+        entries[k].Width = C.width(C.offset(Columns_[k].first) + Columns_[k].second);
+        Bytes_ = aligned(Bytes_ + entries[k].Width * Size_);
+        Offsets_.push_back(entries[k].Offset);
+        Widths_.push_back(entries[k].Width);
+    }
+
+    // write to temporary file and rename in close(),
+    // so that jobs reading the file never see it half written
+    Out_.open(Filename_ + ".tmp", std::ios::binary | std::ios::trunc);
+    if (!Out_)
+        throw exceptions::Exception("could not open " + Filename_ + ".tmp", "StaticDataCacheWriter::StaticDataCacheWriter");
+
+    Out_.write(reinterpret_cast<const char*>(&h), sizeof(Header));
+    Out_.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ColumnEntry));
+}
+
+//-------------------------
+StaticDataCacheWriter::~StaticDataCacheWriter()
+{
+    if (Out_.is_open()) {
+        Out_.close();
+        std::remove((Filename_ + ".tmp").c_str());
+    }
+}
+
+//-------------------------
+void StaticDataCacheWriter::write(const DataSet& D)
+{
+    if (!Out_.is_open())
+        throw exceptions::Exception("writer is closed", "StaticDataCacheWriter::write");
+
+    if (D.model() != Model_ or D.precision() != Precision_)
+        throw exceptions::Exception("DataSet does not match model or precision", "StaticDataCacheWriter::write");
+
+    if (Written_ + D.size() > Size_)
+        throw exceptions::Exception("too many data points", "StaticDataCacheWriter::write");
+
+    const auto& C = D.columns();
+    for (size_t k = 0; k < Columns_.size(); ++k) {
+        Out_.seekp(Offsets_[k] + Written_ * Widths_[k]);
+        Out_.write(static_cast<const char*>(C.column(Columns_[k].first, Columns_[k].second)), Widths_[k] * D.size());
+    }
+
+    if (!Out_)
+        throw exceptions::Exception("could not write " + Filename_ + ".tmp", "StaticDataCacheWriter::write");
+
+    Written_ += D.size();
+}
+
+//-------------------------
+void StaticDataCacheWriter::close()
+{
+    if (!Out_.is_open())
+        return;
+
+    if (Written_ != Size_)
+        throw exceptions::Exception("only " + std::to_string(Written_) + " of " + std::to_string(Size_) + " data points written",
+                                    "StaticDataCacheWriter::close");
+
+    Out_.close();
+
+    // pad file to its full length
+    std::string tmp = Filename_ + ".tmp";
+    if (!Out_ or truncate(tmp.c_str(), Bytes_) != 0 or std::rename(tmp.c_str(), Filename_.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw exceptions::Exception("could not write " + Filename_, "StaticDataCacheWriter::close");
+    }
+}
+
+//-------------------------
+void write_static_data_cache(const DataSet& D, const std::string& filename)
+{
+    if (!D.model())
+        throw exceptions::Exception("Model unset or deleted", "write_static_data_cache");
+
+    StaticDataCacheWriter W(*D.model(), D.precision(), D.size(), filename);
+    W.write(D);
+    W.close();
+}
+
+}
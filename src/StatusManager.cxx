@@ -1,26 +1,26 @@
 #include "StatusManager.h"
 
 #include "CalculationStatus.h"
-#include "Parameter.h"
 #include "VariableStatus.h"
 
+#include <algorithm>
+
 namespace yap {
 
 //-------------------------
-StatusManager::StatusManager(const DataAccessorSet& sDA)
-    : Statuses_(sDA.size())
+StatusManager::StatusManager(const DataAccessorSet& sDA, std::shared_ptr<MemoryArena> arena) :
+    Calculations_(AlignedAllocator<CalculationStatus>(arena)),
+    Variables_(AlignedAllocator<VariableStatus>(arena)),
+    Generations_(sDA.size(), 0)
 {
-    for (const auto& da : sDA) {
-        Statuses_[da->index()].resize(da->CachedValues().size());
-        for (const auto& cdv : da->CachedValues())
-            Statuses_[da->index()][cdv->index()].resize(da->nSymmetrizationIndices());
-    }
-}
+    // positions of statuses are set by Model::lock, ordered by DataAccessor index
+    size_t n = 0;
+    for (const auto& da : sDA)
+        n = std::max<size_t>(n, da->statusOffset() + da->nStatuses());
 
-//-------------------------
-CachedValue::Status& StatusManager::status(const CachedValue& cdv, size_t sym_index)
-{
-    return status(cdv.owner()->index(), cdv.index(), sym_index);
+    CachedValue::Status s;
+    Calculations_.assign(n, s.Calculation);
+    Variables_.assign(n, s.Variable);
 }
 
 }
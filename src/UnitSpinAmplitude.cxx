@@ -1,5 +1,6 @@
 #include "UnitSpinAmplitude.h"
 
+#include "AmplitudePlan.h"
 #include "ClebschGordan.h"
 #include "Exceptions.h"
 #include "ParticleCombination.h"
@@ -30,4 +31,10 @@ UnitSpinAmplitude::UnitSpinAmplitude(Model& m, unsigned two_J, const SpinVector&
     }
 }
 
+//-------------------------
+AmplitudeFactor UnitSpinAmplitude::factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const
+{
+    return AmplitudeFactor(1.);
+}
+
 }
@@ -5,8 +5,11 @@
 #include "MathUtilities.h"
 #include "Spin.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
-#include <mutex>
+#include <memory>
 #include <vector>
 
 namespace yap {
@@ -20,11 +23,76 @@ using KappaFactorVector = std::vector<double>;
 // second index is for J + N, in [0, min(J + M, floor(J))]
 using dMatrix = std::vector<std::vector<KappaFactorVector> >;
 
-// Cache of d-matrix kappa term factors
-// index is for (2J - 1), since J = 0 requires no cache
-static std::vector<dMatrix> CachedMatrices_;
+// Cache of d-matrix kappa term factors, index is for twoJ;
+// entries are set once, atomically, and never changed after,
+// so they can be read without locking
+class Cache
+{
+public:
+
+    Cache()
+    {
+        for (auto& m : Matrices_)
+            m.store(nullptr);
+    }
+
+    ~Cache()
+    {
+        for (auto& m : Matrices_)
+            delete m.load();
+    }
+
+    // \return cached dMatrix for twoJ, nullptr if not yet cached
+    const dMatrix* operator[](unsigned twoJ) const
+    { return Matrices_[twoJ].load(std::memory_order_acquire); }
+
+    // store dMatrix for twoJ, unless another thread already has
+    void store(unsigned twoJ, std::unique_ptr<dMatrix> dJ)
+    {
+        const dMatrix* expected = nullptr;
+        if (Matrices_[twoJ].compare_exchange_strong(expected, dJ.get(), std::memory_order_acq_rel))
+            dJ.release();
+    }
+
+    // \return number of spins that can be cached
+    static constexpr unsigned size()
+    { return max_twoJ + 1; }
+
+private:
+
+    std::array<std::atomic<const dMatrix*>, max_twoJ + 1> Matrices_;
+
+};
 
-static std::mutex CacheMutex_;
+static Cache CachedMatrices_;
+
+// \return cached matrix for twoJ, caching it if necessary
+const dMatrix& cached(unsigned twoJ)
+{
+    cache(twoJ);
+    return *CachedMatrices_[twoJ];
+}
+
+// \return d-matrix element calculated from kappa factors and powers of cos and sin of beta / 2
+// \param KF kappa factors
+// \param c powers of cos(beta / 2)
+// \param s powers of sin(beta / 2)
+inline double element(const KappaFactorVector& KF, unsigned twoJ, unsigned MminusN, const double* c, const double* s)
+{
+    // power for cos is [2J - (M - N) - 2K], power for sin is [(M - N) + 2K]
+    double dMatrixElement = 0;
+    for (unsigned K = 0; K < KF.size(); ++K)
+        dMatrixElement += KF[K] * c[twoJ - MminusN - 2 * K] * s[MminusN + 2 * K];
+    return dMatrixElement;
+}
+
+// fill powers [0, n] of x
+inline void powers(double x, unsigned n, double* p)
+{
+    p[0] = 1;
+    for (unsigned k = 1; k <= n; ++k)
+        p[k] = p[k - 1] * x;
+}
 
 }
 
@@ -60,42 +128,72 @@ const double dFunction(unsigned twoJ, int twoM, int twoN, double beta)
     if (twoJ == 0)
         return 1;
 
-    // cache dMatrix for J if necessary
-    dMatrix::cache(twoJ);
-    // if problem with caching (should not happen!)
-    if (twoJ > dMatrix::CachedMatrices_.size())
-        throw exceptions::Exception(std::string("could not cache Wigner d function for J = ") + spin_to_string(twoJ),
-                                    "WignerD::dFunction");
+    const auto& KF = dMatrix::cached(twoJ)[(twoJ + twoM) / 2][(twoJ + twoN) / 2];
 
-    const dMatrix::KappaFactorVector& KF = dMatrix::CachedMatrices_[twoJ - 1][(twoJ + twoM) / 2][(twoJ + twoN) / 2];
+    // powers of cosine and sine of beta / 2
+    std::array<double, dMatrix::max_twoJ + 1> c;
+    std::array<double, dMatrix::max_twoJ + 1> s;
+    dMatrix::powers(cos(beta / 2), twoJ, c.data());
+    dMatrix::powers(sin(beta / 2), twoJ, s.data());
 
-    unsigned MminusN = (twoM - twoN) / 2;
+    return dMatrix::element(KF, twoJ, (twoM - twoN) / 2, c.data(), s.data());
+}
 
-    // sum over powers of cosine and sine of beta / 2 and multiply by factor
-    double cosHalfBeta = cos(beta / 2); // power for cos is [2J - (M - N) - 2K]
-    double sinHalfBeta = sin(beta / 2); // power for sin is [(M - N) + 2K]
-    double dMatrixElement = 0;
-    for (unsigned K = 0; K < KF.size(); ++K)
-        dMatrixElement += KF[K] * pow(cosHalfBeta, twoJ - MminusN - 2 * K) * pow(sinHalfBeta, MminusN + 2 * K);
+//-------------------------
+void dMatrix::calculate(unsigned twoJ, const double* beta, size_t n, double* d)
+{
+    if (twoJ == 0) {
+        std::fill(d, d + n, 1.);
+        return;
+    }
 
-    return dMatrixElement;
+    const auto& dJ = cached(twoJ);
+
+    const unsigned N = twoJ + 1;
+
+    std::array<double, max_twoJ + 1> c;
+    std::array<double, max_twoJ + 1> s;
+
+    for (size_t i = 0; i < n; ++i) {
+
+        // powers of cosine and sine of beta / 2, shared by all elements
+        powers(cos(beta[i] / 2), twoJ, c.data());
+        powers(sin(beta[i] / 2), twoJ, s.data());
+
+        // loop over cached elements: N <= 0 and N <= M
+        for (unsigned JplusM = 0; JplusM < dJ.size(); ++JplusM)
+            for (unsigned JplusN = 0; JplusN < dJ[JplusM].size(); ++JplusN) {
+
+                unsigned MminusN = JplusM - JplusN;
+                double e = element(dJ[JplusM][JplusN], twoJ, MminusN, c.data(), s.data());
+                double e_sym = pow_negative_one(MminusN) * e;
+
+                // d^J_MN
+                d[(JplusM * N + JplusN) * n + i] = e;
+                // d^J_NM = (-)^(M-N) * d^J_MN
+                d[(JplusN * N + JplusM) * n + i] = e_sym;
+                // d^J_(-M)(-N) = (-)^(M-N) * d^J_MN
+                d[((twoJ - JplusM) * N + twoJ - JplusN) * n + i] = e_sym;
+                // d^J_(-N)(-M) = d^J_MN
+                d[((twoJ - JplusN) * N + twoJ - JplusM) * n + i] = e;
+            }
+    }
 }
 
 //-------------------------
 void dMatrix::cache(unsigned twoJ)
 {
+    if (twoJ > max_twoJ)
+        throw exceptions::Exception("cannot cache Wigner d function for J = " + spin_to_string(twoJ)
+                                    + " > " + spin_to_string(max_twoJ), "dMatrix::cache");
+
     /// d-matrix has already been cached for this spin
-    if (twoJ == 0 or (twoJ <= CachedMatrices_.size() and !CachedMatrices_[twoJ - 1].empty()))
+    if (twoJ == 0 or CachedMatrices_[twoJ])
         return;
 
-    /// resize d-matrix vector to hold up to spin J
-    std::lock_guard<std::mutex> guard(CacheMutex_);
-    if (twoJ > CachedMatrices_.size())
-        CachedMatrices_.resize(twoJ);
-
     double J = (double)twoJ / 2;
 
-    dMatrix dJ(twoJ + 1);
+    std::unique_ptr<dMatrix> dJ(new dMatrix(twoJ + 1));
 
     for (unsigned JplusM = 0; JplusM <= twoJ; ++JplusM) {
 
@@ -104,9 +202,9 @@ void dMatrix::cache(unsigned twoJ)
         // = sqrt( (J + M)! * (J - M)! )
         double JMFactor = sqrt(std::tgamma(JplusM + 1) * std::tgamma(JminusM + 1));
 
-        dJ[JplusM].resize(std::min(JplusM, (unsigned)std::floor(J)) + 1);
+        (*dJ)[JplusM].resize(std::min(JplusM, (unsigned)std::floor(J)) + 1);
 
-        for (unsigned JplusN = 0; JplusN < dJ[JplusM].size(); ++JplusN) {
+        for (unsigned JplusN = 0; JplusN < (*dJ)[JplusM].size(); ++JplusN) {
 
             unsigned JminusN = twoJ - JplusN;
             unsigned MminusN = JplusM - JplusN;
@@ -114,24 +212,29 @@ void dMatrix::cache(unsigned twoJ)
             // = sqrt( (J + N)! * (J - N)! )
             double JNFactor = sqrt(std::tgamma(JplusN + 1) * std::tgamma(JminusN + 1));
 
-            dJ[JplusM][JplusN].resize(std::min(JminusM, JplusN) + 1);
+            (*dJ)[JplusM][JplusN].resize(std::min(JminusM, JplusN) + 1);
 
             // minK is 0, by choice that N <= M
-            for (unsigned K = 0; K < dJ[JplusM][JplusN].size(); ++K)
-                dJ[JplusM][JplusN][K] = pow_negative_one(K + MminusN) * JMFactor * JNFactor
-                                        / std::tgamma(JminusM - K + 1) / std::tgamma(JplusN - K + 1) / std::tgamma(K + MminusN + 1) / std::tgamma(K + 1);
+            for (unsigned K = 0; K < (*dJ)[JplusM][JplusN].size(); ++K)
+                (*dJ)[JplusM][JplusN][K] = pow_negative_one(K + MminusN) * JMFactor * JNFactor
+                                           / std::tgamma(JminusM - K + 1) / std::tgamma(JplusN - K + 1) / std::tgamma(K + MminusN + 1) / std::tgamma(K + 1);
         }
     }
-    CachedMatrices_[twoJ - 1] = dJ;
+
+    // if another thread has cached meanwhile, it is kept and dJ is discarded
+    CachedMatrices_.store(twoJ, std::move(dJ));
 }
 
 //-------------------------
 const unsigned dMatrix::cacheSize()
 {
     unsigned totSize = sizeof(CachedMatrices_);
-    for (const auto& dJ : CachedMatrices_) {
-        totSize += sizeof(dJ);
-        for (const auto& dJrow : dJ) {
+    for (unsigned twoJ = 0; twoJ < Cache::size(); ++twoJ) {
+        const auto* dJ = CachedMatrices_[twoJ];
+        if (!dJ)
+            continue;
+        totSize += sizeof(*dJ);
+        for (const auto& dJrow : *dJ) {
             totSize += sizeof(dJrow);
             for (const auto& dJelt : dJrow) {
                 totSize += sizeof(dJelt) + dJelt.size() * sizeof(KappaFactorVector::value_type);
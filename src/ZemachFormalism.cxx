@@ -1,5 +1,6 @@
 #include "ZemachFormalism.h"
 
+#include "AmplitudePlan.h"
 #include "CachedValue.h"
 #include "Exceptions.h"
 #include "FourMomenta.h"
@@ -111,9 +112,15 @@ void ZemachSpinAmplitude::addParticleCombination(const ParticleCombination& pc)
 
 //-------------------------
 const std::complex<double> ZemachSpinAmplitude::amplitude(const DataPoint& d, const std::shared_ptr<const ParticleCombination>& pc,
-                                                          int two_M, const SpinProjectionVector& two_m) const
+                                                          unsigned i) const
 {
-    return (twoS() == 0 or pc->indices().size() < 3) ? 1. : SpinAmplitude::amplitude(d, pc, two_M, two_m);
+    return (twoS() == 0 or pc->indices().size() < 3) ? 1. : SpinAmplitude::amplitude(d, pc, i);
+}
+
+//-------------------------
+AmplitudeFactor ZemachSpinAmplitude::factor(const std::shared_ptr<const ParticleCombination>& pc, unsigned i) const
+{
+    return (twoS() == 0 or pc->indices().size() < 3) ? AmplitudeFactor(1.) : SpinAmplitude::factor(pc, i);
 }
 
 //-------------------------
@@ -3,18 +3,24 @@
 
 #include <Attributes.h>
 #include <ConstantWidthBreitWigner.h>
+#include <DataPartition.h>
 #include <DataSet.h>
 #include <DecayingParticle.h>
 #include <FinalStateParticle.h>
 #include <FourVector.h>
 #include <FreeAmplitude.h>
 #include <HelicityFormalism.h>
+#include <ImportanceSampler.h>
+#include <logging.h>
 #include <MassAxes.h>
+#include <MemoryArena.h>
 #include <Model.h>
+#include <ModelIntegral.h>
 #include <PDL.h>
 #include <PHSP.h>
 #include <Parameter.h>
 #include <ParticleTable.h>
+#include <VariableStatus.h>
 #include <make_unique.h>
 
 #include <Group.h>
@@ -132,7 +138,9 @@ std::shared_ptr<yap::Model> d3pi()
 }
 
 //-------------------------
-inline yap::DataSet generate_data(yap::Model& M, unsigned nPoints)
+inline yap::DataSet generate_data(yap::Model& M, unsigned nPoints,
+                                  yap::StoragePrecision precision = yap::StoragePrecision::double_precision,
+                                  std::shared_ptr<yap::MemoryArena> arena = nullptr)
 {
     auto T = yap::read_pdl_file(find_pdl_file());
     
@@ -141,7 +149,8 @@ inline yap::DataSet generate_data(yap::Model& M, unsigned nPoints)
     auto A = M.massAxes();
     auto m2r = yap::squared(yap::mass_range(isp_mass, A, M.finalStateParticles()));
 
-    yap::DataSet data(M.createDataSet());
+    yap::DataSet data(M.createDataSet(0, precision, arena));
+    data.reserve(nPoints);
 
     std::mt19937 g(0);
     // fill data set with nPoints points
@@ -151,6 +160,67 @@ inline yap::DataSet generate_data(yap::Model& M, unsigned nPoints)
     return data;
 }
 
+/// \return mass shape of named decaying particle in model cast to T, nullptr if not found
+//-------------------------
+template <typename T>
+std::shared_ptr<T> mass_shape(const yap::Model& M, const std::string& name)
+{
+    for (const auto& p : particles(M))
+        if (p->name() == name and std::dynamic_pointer_cast<yap::DecayingParticle>(p))
+            return std::dynamic_pointer_cast<T>(std::static_pointer_cast<yap::DecayingParticle>(p)->massShape());
+    return nullptr;
+}
+
+/// delete data partitions created by DataPartitionBlock::create
+//-------------------------
+inline void delete_partitions(yap::DataPartitionVector& DP)
+{
+    for (auto p : DP)
+        delete p;
+    DP.clear();
+}
+
+/// \struct fit_fixture
+/// d4pi model with data and integration data,
+/// partitioned, and with integral calculated by importance sampling
+struct fit_fixture {
+    /// \param n_data number of data points
+    /// \param n_int number of integration points
+    /// \param n_partitions number of partitions of data
+    /// \param free_admixtures whether to free the admixtures of model
+    fit_fixture(unsigned n_data, unsigned n_int, unsigned n_partitions, bool free_admixtures = false) :
+        // disable debug logs before generating data
+        M((yap::disableLogs(el::Level::Debug), d4pi())),
+        D(generate_data(*M, n_data)),
+        DP(yap::DataPartitionBlock::create(D, n_partitions)),
+        D_int(generate_data(*M, n_int)),
+        DP_int(yap::DataPartitionBlock::create(D_int, 2)),
+        I(*M)
+    {
+        if (free_admixtures)
+            for (const auto& c : M->components())
+                c.admixture()->variableStatus() = yap::VariableStatus::unchanged;
+        yap::ImportanceSampler::calculate(I, DP_int);
+    }
+
+    /// partitions point into data sets
+    fit_fixture(const fit_fixture&) = delete;
+    fit_fixture& operator=(const fit_fixture&) = delete;
+
+    ~fit_fixture()
+    {
+        delete_partitions(DP);
+        delete_partitions(DP_int);
+    }
+
+    std::shared_ptr<yap::Model> M;
+    yap::DataSet D;
+    yap::DataPartitionVector DP;
+    yap::DataSet D_int;
+    yap::DataPartitionVector DP_int;
+    yap::ModelIntegral I;
+};
+
 
 
 #endif
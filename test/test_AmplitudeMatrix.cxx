@@ -0,0 +1,43 @@
+#include <catch.hpp>
+
+#include <AmplitudeMatrix.h>
+#include <ConstantWidthBreitWigner.h>
+#include <DataSet.h>
+#include <Exceptions.h>
+#include <FreeAmplitude.h>
+#include <HelicityFormalism.h>
+#include <logging.h>
+#include <Model.h>
+#include <Parameter.h>
+#include <VariableStatus.h>
+
+#include "helperFunctions.h"
+
+#include <complex>
+
+TEST_CASE( "AmplitudeMatrix" )
+{
+    // disable debug logs in test
+    yap::disableLogs(el::Level::Debug);
+
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 100);
+
+    yap::AmplitudeMatrix A(*M, D);
+    REQUIRE( sum_of_log_intensity(*M, A) == Approx(sum_of_log_intensity(*M, D)) );
+    REQUIRE( A.rows() == D.size() );
+
+    // change free amplitudes only
+    for (auto& fa : free_amplitudes(*M))
+        if (fa->variableStatus() != yap::VariableStatus::fixed)
+            *fa = 2. * fa->value() * std::polar(1., 0.4);
+    REQUIRE( sum_of_log_intensity(*M, A, 1.) == Approx(sum_of_log_intensity(*M, D, 1.)) );
+
+    // change mass shape, recalculating columns depending on it
+    auto bw = mass_shape<yap::ConstantWidthBreitWigner>(*M, "rho0");
+    REQUIRE( bw );
+    bw->mass()->setValue(0.8);
+    REQUIRE( sum_of_log_intensity(*M, A) == Approx(sum_of_log_intensity(*M, D)) );
+
+    REQUIRE_THROWS_AS( sum_of_log_intensity(*d3pi<yap::HelicityFormalism>(), A), yap::exceptions::Exception );
+}
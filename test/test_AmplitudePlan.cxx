@@ -0,0 +1,58 @@
+#include <catch.hpp>
+#include <catch_capprox.hpp>
+
+#include <AmplitudePlan.h>
+#include <DataSet.h>
+#include <DecayTree.h>
+#include <FreeAmplitude.h>
+#include <HelicityFormalism.h>
+#include <logging.h>
+#include <Model.h>
+#include <VariableStatus.h>
+#include <ZemachFormalism.h>
+
+#include "helperFunctions.h"
+
+#include <memory>
+#include <vector>
+
+TEST_CASE( "AmplitudePlan" )
+{
+    // disable debug logs in test
+    yap::disableLogs(el::Level::Debug);
+
+    std::vector<std::shared_ptr<yap::Model> > models = {
+        d3pi<yap::HelicityFormalism>(),
+        d4pi(),
+        dkkp<yap::ZemachFormalism>(411, {321, -321, 211}),
+        dkkp<yap::HelicityFormalism>(411, {321, -321, 211})
+    };
+
+    for (auto& M : models) {
+        // give free amplitudes distinct values
+        double x = 0.;
+        for (auto& fa : free_amplitudes(*M))
+            if (fa->variableStatus() != yap::VariableStatus::fixed) {
+                x += 0.3;
+                *fa = std::polar(1. + x, x);
+            }
+
+        auto D = generate_data(*M, 20);
+        sum_of_log_intensity(*M, D);
+
+        for (const auto& c : M->components()) {
+            const auto& plan = *c.amplitudePlan();
+            REQUIRE( plan.size() == c.decayTrees().size() );
+
+            auto A = plan.dataIndependentAmplitudes();
+            for (size_t i = 0; i < A.size(); ++i)
+                REQUIRE( A[i] == Catch::Detail::CApprox(c.decayTrees()[i]->dataIndependentAmplitude()) );
+
+            for (const auto& d : D) {
+                for (size_t i = 0; i < c.decayTrees().size(); ++i)
+                    REQUIRE( plan.dataDependentAmplitude(d, i) == Catch::Detail::CApprox(c.decayTrees()[i]->dataDependentAmplitude(d)) );
+                REQUIRE( plan.amplitude(d) == Catch::Detail::CApprox(amplitude(c.decayTrees(), d)) );
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#include <catch.hpp>
+
+#include <BlattWeisskopf.h>
+
+#include <vector>
+
+TEST_CASE( "BlattWeisskopf" )
+{
+    std::vector<double> Z = {0.01, 0.1, 0.5, 1., 2., 10., 100.};
+
+    SECTION( "Hankel recursion reproduces closed forms" ) {
+        for (double z : Z) {
+            REQUIRE( yap::hankel_squared_barrier_factor(0, z) == 1 );
+            REQUIRE( yap::hankel_squared_barrier_factor(1, z) == Approx(yap::squared_barrier_factor<1>(z)) );
+            REQUIRE( yap::hankel_squared_barrier_factor(2, z) == Approx(yap::squared_barrier_factor<2>(z)) );
+            REQUIRE( yap::hankel_squared_barrier_factor(3, z) == Approx(yap::squared_barrier_factor<3>(z)) );
+            REQUIRE( yap::hankel_squared_barrier_factor(4, z) == Approx(yap::squared_barrier_factor<4>(z)) );
+            REQUIRE( yap::hankel_squared_barrier_factor(5, z) == Approx(yap::squared_barrier_factor<5>(z)) );
+            REQUIRE( yap::hankel_squared_barrier_factor(6, z) == Approx(yap::squared_barrier_factor<6>(z)) );
+            REQUIRE( yap::hankel_squared_barrier_factor(7, z) == Approx(yap::squared_barrier_factor<7>(z)) );
+        }
+    }
+
+    SECTION( "normalization" ) {
+        for (unsigned l = 0; l < 12; ++l)
+            REQUIRE( yap::squared_barrier_factor(l, 1.) == Approx(1) );
+        REQUIRE( yap::squared_barrier_factor(10, 0.) == 0 );
+    }
+
+    SECTION( "arrays" ) {
+        for (unsigned l = 0; l < 12; ++l) {
+            std::vector<double> F2(Z.size());
+            yap::squared_barrier_factors(l, F2.data(), Z.data(), Z.size());
+            for (size_t i = 0; i < Z.size(); ++i)
+                REQUIRE( F2[i] == Approx(yap::squared_barrier_factor(l, Z[i])) );
+        }
+    }
+}
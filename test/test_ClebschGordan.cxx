@@ -6,6 +6,8 @@
 #include <MathUtilities.h>
 #include <Spin.h>
 
+#include <cmath>
+
 TEST_CASE( "ClebschGordan" )
 {
 
@@ -52,6 +54,20 @@ TEST_CASE( "ClebschGordan" )
                             }
         }
 
+        SECTION ( "Orthonormality" ) {
+            // sum over m1 of (j1 m1 j2 M-m1 | J M)^2 is 1, for large spins too
+            for (unsigned two_j1 : {2u, 7u, 16u, 30u})
+                for (unsigned two_j2 : {1u, 4u, 12u})
+                    for (unsigned two_J = abs((int)two_j1 - (int)two_j2); two_J <= two_j1 + two_j2; two_J += 2)
+                        for (int two_M : yap::projections(two_J)) {
+                            double sum = 0;
+                            for (int two_m1 : yap::projections(two_j1))
+                                if (yap::ClebschGordan::consistent(two_j2, two_M - two_m1))
+                                    sum += pow(yap::ClebschGordan::coefficient(two_j1, two_m1, two_j2, two_M - two_m1, two_J, two_M), 2);
+                            REQUIRE( sum == Approx(1) );
+                        }
+        }
+
         SECTION ( "j2 = 0" ) {
             for (unsigned two_j1 = 0; two_j1 <= 10; ++two_j1)
                 for (int two_m1 = -two_j1; two_m1 <= (int)two_j1; two_m1 += 2) {
@@ -2,12 +2,22 @@
 
 #include "helperFunctions.h"
 
+#include <CachedValue.h>
+#include <CalculationStatus.h>
 #include <DataSet.h>
+#include <DataAccessor.h>
 #include <Exceptions.h>
+#include <FourMomenta.h>
 #include <HelicityFormalism.h>
 #include <logging.h>
 #include <make_unique.h>
+#include <MemoryArena.h>
 #include <Model.h>
+#include <StaticDataCache.h>
+#include <VariableStatus.h>
+
+#include <algorithm>
+#include <cstdio>
 
 TEST_CASE("DataSet")
 {
@@ -34,3 +44,328 @@ TEST_CASE("DataSet")
     REQUIRE_NOTHROW( D3.erase(D3.begin() + 1, D3.end()) );
     REQUIRE_THROWS_AS( D3.erase(D4.begin(), D3.end()), yap::exceptions::Exception );
 }
+
+TEST_CASE("DataSet_columns")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 20);
+
+    REQUIRE( D.size() == 20 );
+    REQUIRE( D.bytes() == D.size() * D[0].bytes() );
+
+    // DataPoint's are handles to rows of the DataSet
+    auto d5 = D[5];
+    REQUIRE( d5 == D[5] );
+    REQUIRE( d5.row() == 5 );
+
+    // inserting a copy of a row behind it keeps values
+    auto d = D[5];
+    D.insert(D.begin() + 2, d);
+    REQUIRE( D.size() == 21 );
+    REQUIRE( D[2] == D[6] );
+
+    // erasing shifts following rows
+    D.erase(D.begin() + 2);
+    REQUIRE( D.size() == 20 );
+    REQUIRE_FALSE( D[2] == D[5] );
+
+    // iteration visits every row once
+    size_t n = 0;
+    for (auto& p : D)
+        REQUIRE( p.row() == n++ );
+    REQUIRE( n == D.size() );
+
+    // copies of a DataSet have their own storage
+    auto D2 = D;
+    D2.erase(D2.begin(), D2.begin() + 1);
+    REQUIRE( D2.size() == D.size() - 1 );
+    REQUIRE( D2[0] == D[1] );
+}
+
+TEST_CASE("DataSet_statuses")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = M->createDataSet(1);
+
+    // statuses of all cached values lie back to back
+    unsigned n = 0;
+    for (const auto& da : M->dataAccessors()) {
+        REQUIRE( da->statusOffset() == n );
+        for (const auto& c : da->CachedValues())
+            REQUIRE( c->statusOffset() == n + c->index() * da->nSymmetrizationIndices() );
+        n += da->nStatuses();
+    }
+
+    const auto& c = **M->fourMomenta()->CachedValues().begin();
+    D.status(c, 0) = yap::VariableStatus::fixed;
+
+    D.setAll(yap::CalculationStatus::calculated);
+    D.setAll(yap::VariableStatus::unchanged);
+    REQUIRE( D.status(c, 0) == yap::CalculationStatus::calculated );
+    REQUIRE( D.status(c, 0) == yap::VariableStatus::fixed );
+
+    // copies are independent
+    yap::StatusManager sm(D);
+    sm.set(c, yap::CalculationStatus::uncalculated);
+    REQUIRE( sm.status(c, 0) == yap::CalculationStatus::uncalculated );
+    REQUIRE( D.status(c, 0) == yap::CalculationStatus::calculated );
+}
+
+TEST_CASE("DataSet_iterators")
+{
+    auto M = d4pi();
+    auto D = generate_data(*M, 200);
+
+    // begin and end are held by the data set and follow changes to its size
+    const auto& b = D.begin();
+    const auto& e = D.end();
+    REQUIRE( e - b == static_cast<long>(D.size()) );
+    D.erase(D.begin());
+    REQUIRE( &D.end() == &e );
+    REQUIRE( e - b == static_cast<long>(D.size()) );
+    D.push_back(D[0]);
+    REQUIRE( e - b == static_cast<long>(D.size()) );
+
+    // copies and moves iterate over their own rows
+    auto D_copy = D;
+    REQUIRE( D_copy.begin().partition() == &D_copy );
+    REQUIRE( D_copy.end() - D_copy.begin() == static_cast<long>(D.size()) );
+    auto D_moved = std::move(D_copy);
+    REQUIRE( D_moved.begin().partition() == &D_moved );
+    REQUIRE( D_moved.end() - D_moved.begin() == static_cast<long>(D.size()) );
+    for (size_t i = 0; i < D.size(); ++i)
+        REQUIRE( D_moved[i] == D[i] );
+
+    // data accessors calculated in parallel on one data set
+    auto D_serial = D;
+    REQUIRE( sum_of_log_intensity(*M, D, 0, 4) == Approx(sum_of_log_intensity(*M, D_serial)) );
+    for (size_t i = 0; i < D.size(); ++i)
+        REQUIRE( D[i] == D_serial[i] );
+}
+
+TEST_CASE("DataPartitionWeave")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+
+    // number of points not a multiple of number of partitions
+    auto D = generate_data(*M, 10);
+    auto P = yap::DataPartitionWeave::create(D, 3);
+    REQUIRE( P.size() == 3 );
+
+    // every point is in exactly one partition
+    std::vector<unsigned> n(D.size(), 0);
+    for (const auto& p : P) {
+        size_t i = 0;
+        for (const auto& d : *p) {
+            REQUIRE( d.row() < D.size() );
+            ++n[d.row()];
+            ++i;
+        }
+        REQUIRE( i == p->size() );
+    }
+    REQUIRE( std::all_of(n.begin(), n.end(), [](unsigned k) {return k == 1;}) );
+    REQUIRE( P[0]->size() == 4 );
+    REQUIRE( P[1]->size() == 3 );
+    REQUIRE( P[2]->size() == 3 );
+
+    // batched calculations reach last point of each partition
+    REQUIRE( sum_of_log_intensity(*M, P) == Approx(sum_of_log_intensity(*M, D)) );
+
+    for (auto p : P)
+        delete p;
+}
+
+TEST_CASE("DataSet_arena")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+
+    auto arena = std::make_shared<yap::MemoryArena>(1 << 26, true);
+    REQUIRE( arena->used() == 0 );
+
+    auto D_arena = generate_data(*M, 100, yap::StoragePrecision::double_precision, arena);
+    auto D_heap = generate_data(*M, 100);
+
+    REQUIRE( D_arena.arena() == arena );
+    REQUIRE( D_heap.arena() == nullptr );
+    REQUIRE( D_arena.size() == D_heap.size() );
+
+    // columns and status table carved from arena, in one piece each
+    REQUIRE( arena->used() >= D_arena.bytes() );
+    REQUIRE( arena->used() < 2 * D_arena.bytes() + 4096 );
+
+    for (size_t i = 0; i < D_arena.size(); ++i)
+        REQUIRE( D_arena[i] == D_heap[i] );
+
+    // status tables of partitions are carved from arena
+    auto used = arena->used();
+    auto P = yap::DataPartitionBlock::create(D_arena, 4);
+    REQUIRE( arena->used() > used );
+
+    REQUIRE( sum_of_log_intensity(*M, P) == Approx(sum_of_log_intensity(*M, D_heap)) );
+
+    for (auto p : P)
+        delete p;
+}
+
+TEST_CASE("DataSet_precision")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 10);
+
+    unsigned n_double = 0;
+    unsigned n_single = 0;
+    for (const auto& da : M->dataAccessors())
+        for (const auto& c : da->CachedValues())
+            (c->precision() == yap::StoragePrecision::single_precision ? n_single : n_double)
+                += c->size() * da->nSymmetrizationIndices();
+
+    // four-momenta are stored in double, and spin amplitudes in float
+    REQUIRE( n_double > 0 );
+    REQUIRE( n_single > 0 );
+    REQUIRE( D[0].bytes() == n_double * sizeof(double) + n_single * sizeof(float) );
+
+    // four-momenta and masses are stored with full precision
+    for (const auto& c : M->fourMomenta()->CachedValues())
+        REQUIRE( c->precision() == yap::StoragePrecision::double_precision );
+
+    // single-precision data set stores everything as float
+    auto D_single = generate_data(*M, 10, yap::StoragePrecision::single_precision);
+    REQUIRE( D_single.precision() == yap::StoragePrecision::single_precision );
+    REQUIRE( D_single[0].bytes() == (n_double + n_single) * sizeof(float) );
+
+    // data points of different precisions are inconsistent
+    REQUIRE_FALSE( D_single.consistent(D[0]) );
+    REQUIRE_THROWS_AS( D_single.push_back(D[0]), yap::exceptions::InconsistentDataPoint );
+
+    REQUIRE( sum_of_log_intensity(*M, D_single) == Approx(sum_of_log_intensity(*M, D)).epsilon(1e-5) );
+}
+
+TEST_CASE("DataSet_fixed_point")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 100);
+    auto D_single = generate_data(*M, 100, yap::StoragePrecision::single_precision);
+    auto D_fixed = generate_data(*M, 100, yap::StoragePrecision::fixed_point);
+
+    REQUIRE( D.quantizationError() == 0 );
+    REQUIRE( D_single.quantizationError() == 0 );
+    REQUIRE( D_fixed.quantizationError() > 0 );
+    REQUIRE( D_fixed.quantizationError() < 1e-4 );
+
+    // spin amplitudes are stored as fixed point, everything else as float
+    unsigned n_fixed = 0;
+    for (const auto& da : M->dataAccessors())
+        for (const auto& c : da->CachedValues())
+            if (c->storagePrecision(yap::StoragePrecision::fixed_point) == yap::StoragePrecision::fixed_point)
+                n_fixed += c->size() * da->nSymmetrizationIndices();
+    REQUIRE( n_fixed > 0 );
+    REQUIRE( D_fixed[0].bytes() == D_single[0].bytes() - n_fixed * (sizeof(float) - sizeof(int16_t)) );
+
+    // fixed-point values agree within reported error (and float rounding of the reference,
+    // which like D_fixed is calculated from four-momenta stored as float)
+    for (const auto& da : M->dataAccessors())
+        for (const auto& c : da->CachedValues())
+            if (c->quantizationError(D_fixed.precision()) > 0)
+                for (size_t i = 0; i < D.size(); ++i)
+                    for (unsigned s = 0; s < da->nSymmetrizationIndices(); ++s)
+                        for (unsigned k = 0; k < c->size(); ++k)
+                            REQUIRE( std::abs(c->value(k, D_fixed[i], s) - c->value(k, D_single[i], s))
+                                     <= c->quantizationError(D_fixed.precision()) + 1e-7 * c->bound() );
+
+    REQUIRE( sum_of_log_intensity(*M, D_fixed) == Approx(sum_of_log_intensity(*M, D)).epsilon(1e-3) );
+}
+
+TEST_CASE("DataSet_static_cache")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 100);
+
+    const std::string filename = "test_DataSet_static_cache.yapsdc";
+    yap::write_static_data_cache(D, filename);
+
+    auto cache = std::make_shared<yap::StaticDataCache>(filename);
+    REQUIRE( cache->key() == yap::static_data_key(*M, D.precision()) );
+    REQUIRE( cache->precision() == D.precision() );
+    REQUIRE( cache->size() == D.size() );
+
+    auto D_mapped = M->createDataSet();
+    D_mapped.map(cache);
+    REQUIRE( D_mapped.mapped() );
+    REQUIRE( D_mapped.size() == D.size() );
+
+    // nothing but static values has been calculated yet
+    for (size_t i = 0; i < D.size(); ++i)
+        REQUIRE( D_mapped[i] == D[i] );
+
+    REQUIRE( sum_of_log_intensity(*M, D_mapped) == Approx(sum_of_log_intensity(*M, D)) );
+    REQUIRE( D_mapped.mapped() );
+
+    // copies don't share mapped columns, so erasing from one leaves the other unchanged
+    auto D_copy = D_mapped;
+    REQUIRE_FALSE( D_copy.mapped() );
+    D_copy.erase(D_copy.begin());
+    REQUIRE( D_copy.size() == D.size() - 1 );
+    REQUIRE( D_mapped.mapped() );
+    REQUIRE( D_mapped.size() == D.size() );
+    for (size_t i = 0; i < D.size(); ++i) {
+        REQUIRE( D_mapped[i] == D[i] );
+        if (i > 0)
+            REQUIRE( D_copy[i - 1] == D[i] );
+    }
+
+    // adding data points moves mapped columns into own storage
+    D_mapped.push_back(D[0]);
+    REQUIRE_FALSE( D_mapped.mapped() );
+    REQUIRE( D_mapped.size() == D.size() + 1 );
+    for (size_t i = 0; i < D.size(); ++i)
+        REQUIRE( D_mapped[i] == D[i] );
+
+    // cache of a different model or precision is rejected
+    auto M4 = d4pi();
+    auto D4 = M4->createDataSet();
+    REQUIRE_THROWS_AS( D4.map(cache), yap::exceptions::Exception );
+    auto D_single = M->createDataSet(0, yap::StoragePrecision::single_precision);
+    REQUIRE_THROWS_AS( D_single.map(cache), yap::exceptions::Exception );
+
+    std::remove(filename.c_str());
+    REQUIRE_THROWS_AS( yap::StaticDataCache(filename), yap::exceptions::Exception );
+}
+
+TEST_CASE("DataSet_streaming")
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 1000);
+
+    // write in chunks
+    const std::string filename = "test_DataSet_streaming.yapsdc";
+    yap::StaticDataCacheWriter W(*M, D.precision(), D.size(), filename);
+    for (size_t first = 0; first < D.size(); first += 300) {
+        auto C = M->createDataSet();
+        for (size_t i = first; i < std::min<size_t>(first + 300, D.size()); ++i)
+            C.push_back(D[i]);
+        W.write(C);
+    }
+    REQUIRE( W.size() == D.size() );
+    W.close();
+
+    auto cache = std::make_shared<yap::StaticDataCache>(filename);
+    REQUIRE( cache->size() == D.size() );
+
+    auto L = sum_of_log_intensity(*M, D);
+
+    // chunk sizes that do and don't divide the number of data points
+    REQUIRE( sum_of_log_intensity(*M, cache, 100) == Approx(L) );
+    REQUIRE( sum_of_log_intensity(*M, cache, 96) == Approx(L) );
+    REQUIRE( sum_of_log_intensity(*M, cache, 5000) == Approx(L) );
+    REQUIRE( sum_of_log_intensity(*M, cache, 96, 3) == Approx(L) );
+
+    std::remove(filename.c_str());
+
+    // file is not moved into place unless all data points are written
+    {
+        yap::StaticDataCacheWriter W2(*M, D.precision(), D.size() + 1, filename);
+        W2.write(D);
+        REQUIRE_THROWS_AS( W2.close(), yap::exceptions::Exception );
+    }
+    REQUIRE_THROWS_AS( yap::StaticDataCache(filename), yap::exceptions::Exception );
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+
+#include <EnsembleSampler.h>
+#include <Exceptions.h>
+#include <FreeAmplitude.h>
+#include <LogLikelihood.h>
+#include <Model.h>
+#include <ModelIntegral.h>
+#include <Parameter.h>
+#include <VariableStatus.h>
+
+#include "helperFunctions.h"
+
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+
+TEST_CASE( "EnsembleSampler" )
+{
+    // free admixtures, to test their bounds too
+    fit_fixture F(200, 400, 2, true);
+    auto& M = F.M;
+    auto& DP = F.DP;
+    auto& I = F.I;
+
+    REQUIRE_THROWS_AS( yap::EnsembleSampler(*M, DP, I, 3), yap::exceptions::Exception );
+
+    yap::EnsembleSampler S(*M, DP, I, 32, 1);
+    auto L = log_likelihood(*M, DP, I);
+    REQUIRE( S.freeAmplitudes() == L.FreeAmplitudes );
+    REQUIRE( S.admixtures() == L.Admixtures );
+
+    // batched log-likelihoods agree with model's
+    auto x0 = S.parameters();
+    auto x1 = x0;
+    for (size_t i = 0; i < x1.size(); ++i)
+        x1[i] *= 1.1;
+    auto x_out = x0;
+    x_out.back() = -1.;
+    auto L_batch = S.logLikelihood({x0, x1, x_out});
+    REQUIRE( L_batch[0] == Approx(L.Value) );
+    REQUIRE( L_batch[2] == -std::numeric_limits<double>::infinity() );
+
+    for (size_t i = 0; i < S.freeAmplitudes().size(); ++i)
+        *S.freeAmplitudes()[i] = std::complex<double>(x1[2 * i], x1[2 * i + 1]);
+    for (size_t i = 0; i < S.admixtures().size(); ++i)
+        *S.admixtures()[i] = x1[2 * S.freeAmplitudes().size() + i];
+    REQUIRE( L_batch[1] == Approx(log_likelihood(*M, DP, I).Value) );
+    REQUIRE( L_batch[1] != Approx(L_batch[0]) );
+
+    // run, writing chain
+    const std::string filename = "test_EnsembleSampler.yapmcmc";
+    const unsigned n_steps = 10;
+    S.openChainFile(filename);
+    S.run(n_steps);
+    S.closeChainFile();
+
+    REQUIRE( S.walkers().size() == 32 );
+    REQUIRE( S.acceptanceRate() > 0 );
+    auto L_walkers = S.logLikelihood(S.walkers());
+    for (size_t w = 0; w < L_walkers.size(); ++w) {
+        REQUIRE( S.logLikelihoods()[w] == Approx(L_walkers[w]) );
+        for (size_t i = 2 * S.freeAmplitudes().size(); i < S.nParameters(); ++i)
+            REQUIRE( S.walkers()[w][i] >= 0 );
+    }
+
+    std::ifstream chain(filename, std::ios::binary | std::ios::ate);
+    REQUIRE( chain.good() );
+    REQUIRE( static_cast<size_t>(chain.tellg()) == 24 + n_steps * 32 * (S.nParameters() + 1) * sizeof(double) );
+    chain.seekg(0);
+    char magic[8];
+    chain.read(magic, 8);
+    REQUIRE( std::string(magic) == "YAPMCMC" );
+    chain.close();
+    std::remove(filename.c_str());
+
+    // changed values of fixed free amplitudes are taken up by next run
+    auto fixed = free_amplitudes(*M, yap::is_fixed());
+    REQUIRE_FALSE( fixed.empty() );
+    auto fa_fixed = *fixed.begin();
+    auto L_before = S.logLikelihood({S.parameters()})[0];
+    fa_fixed->variableStatus() = yap::VariableStatus::unchanged;
+    *fa_fixed = 2. * fa_fixed->value();
+    fa_fixed->variableStatus() = yap::VariableStatus::fixed;
+    S.run(0);
+    REQUIRE( S.logLikelihood({S.parameters()})[0] == Approx(log_likelihood(*M, DP, I).Value) );
+    REQUIRE( S.logLikelihood({S.parameters()})[0] != Approx(L_before) );
+
+    // changed set of free parameters is refused
+    fa_fixed->variableStatus() = yap::VariableStatus::unchanged;
+    REQUIRE_THROWS_AS( S.run(1), yap::exceptions::Exception );
+    fa_fixed->variableStatus() = yap::VariableStatus::fixed;
+    REQUIRE_NOTHROW( S.run(1) );
+}
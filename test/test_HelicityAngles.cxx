@@ -92,6 +92,9 @@ TEST_CASE( "HelicityAngles" )
 
     auto M = d4pi();
 
+    // angles are stored for helicity spin amplitudes' particle combinations
+    REQUIRE_FALSE( M->helicityAngles().symmetrizationIndices().empty() );
+
     // choose default Dalitz axes
     auto A = M->massAxes();
     // get mass^2 ranges
@@ -126,8 +129,8 @@ TEST_CASE( "HelicityAngles" )
 
         // compare results
         for (auto& kv : hel_angles) {
-            REQUIRE( cos(M->helicityAngles()(dp, data, kv.first).phi)   == Approx(cos(kv.second.phi)) );
-            REQUIRE( M->helicityAngles()(dp, data, kv.first).theta == Approx(kv.second.theta) );
+            REQUIRE( cos(M->helicityAngles()(dp, kv.first).phi)   == Approx(cos(kv.second.phi)) );
+            REQUIRE( M->helicityAngles()(dp, kv.first).theta == Approx(kv.second.theta) );
         }
     }
 }
@@ -109,7 +109,7 @@ TEST_CASE( "HelicityAngles_boostRotate" )
             
             // compare results
             for (auto& pc_rho : rho->particleCombinations())
-                resultingThetas[pc_rho].push_back(M->helicityAngles()(dp, data, pc_rho).theta);
+                resultingThetas[pc_rho].push_back(M->helicityAngles()(dp, pc_rho).theta);
         }
 
         // check if thetas are equal
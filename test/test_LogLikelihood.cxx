@@ -0,0 +1,125 @@
+#include <catch.hpp>
+#include <catch_capprox.hpp>
+
+#include <DataSet.h>
+#include <FreeAmplitude.h>
+#include <LogLikelihood.h>
+#include <Model.h>
+#include <ModelIntegral.h>
+#include <Parameter.h>
+
+#include "helperFunctions.h"
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+TEST_CASE( "LogLikelihood_gradient" )
+{
+    // free admixtures, to test their derivatives too
+    fit_fixture F(100, 200, 3, true);
+    auto& M = F.M;
+    auto& D = F.D;
+    auto& I = F.I;
+
+    auto L = log_likelihood(*M, D, I);
+    REQUIRE( L.Value == Approx(sum_of_log_intensity(*M, D, log(integral(I).value()))) );
+    REQUIRE( L.FreeAmplitudes.size() == L.FreeAmplitudeGradient.size() );
+    REQUIRE_FALSE( L.FreeAmplitudes.empty() );
+    REQUIRE( L.Admixtures.size() == M->components().size() );
+
+    // partitioned calculation agrees
+    auto L_DP = log_likelihood(*M, F.DP, I);
+    REQUIRE( L_DP.Value == Approx(L.Value) );
+    REQUIRE( L_DP.FreeAmplitudes == L.FreeAmplitudes );
+    for (size_t i = 0; i < L.FreeAmplitudeGradient.size(); ++i)
+        REQUIRE( L_DP.FreeAmplitudeGradient[i] == Catch::Detail::CApprox(L.FreeAmplitudeGradient[i]) );
+
+    // compare to central finite differences
+    const double h = 1.e-6;
+    auto ll = [&]() {return sum_of_log_intensity(*M, D, log(integral(I).value()));};
+
+    for (size_t i = 0; i < L.FreeAmplitudes.size(); ++i) {
+        auto& fa = *L.FreeAmplitudes[i];
+        const auto a = fa.value();
+
+        fa = a + h;
+        auto up = ll();
+        fa = a - h;
+        auto dn = ll();
+        REQUIRE( real(L.FreeAmplitudeGradient[i]) == Approx((up - dn) / 2. / h).epsilon(1.e-4).scale(1.) );
+
+        fa = a + std::complex<double>(0, h);
+        up = ll();
+        fa = a - std::complex<double>(0, h);
+        dn = ll();
+        REQUIRE( imag(L.FreeAmplitudeGradient[i]) == Approx((up - dn) / 2. / h).epsilon(1.e-4).scale(1.) );
+
+        fa = a;
+    }
+
+    for (size_t i = 0; i < L.Admixtures.size(); ++i) {
+        auto& adm = *L.Admixtures[i];
+        const auto a = adm.value();
+
+        adm = a + h;
+        auto up = ll();
+        adm = a - h;
+        auto dn = ll();
+        REQUIRE( L.AdmixtureGradient[i] == Approx((up - dn) / 2. / h).epsilon(1.e-4).scale(1.) );
+
+        adm = a;
+    }
+}
+
+TEST_CASE( "LogLikelihood_hessian" )
+{
+    fit_fixture F(100, 200, 3);
+    auto& M = F.M;
+    auto& D = F.D;
+    auto& I = F.I;
+
+    auto L = log_likelihood_hessian(*M, D, I);
+    auto L_grad = log_likelihood(*M, D, I);
+    REQUIRE( L.Value == Approx(L_grad.Value) );
+    REQUIRE( L.FreeAmplitudes == L_grad.FreeAmplitudes );
+    REQUIRE( L_grad.FreeAmplitudeHessian.empty() );
+
+    const auto P = 2 * L.FreeAmplitudes.size();
+    REQUIRE( L.FreeAmplitudeHessian.size() == P );
+
+    // partitioned calculation agrees
+    auto L_DP = log_likelihood_hessian(*M, F.DP, I);
+    for (size_t p = 0; p < P; ++p)
+        for (size_t q = 0; q < P; ++q)
+            REQUIRE( L_DP.FreeAmplitudeHessian[p][q] == Approx(L.FreeAmplitudeHessian[p][q]).scale(1.) );
+
+    // compare to central finite differences of gradient
+    const double h = 1.e-6;
+    auto gradient = [&]() {
+        auto G = log_likelihood(*M, D, I).FreeAmplitudeGradient;
+        std::vector<double> g;
+        for (const auto& z : G) {
+            g.push_back(real(z));
+            g.push_back(imag(z));
+        }
+        return g;
+    };
+
+    for (size_t p = 0; p < P; ++p) {
+        auto& fa = *L.FreeAmplitudes[p / 2];
+        const auto a = fa.value();
+        const auto dp = (p % 2 == 0) ? std::complex<double>(h, 0) : std::complex<double>(0, h);
+
+        fa = a + dp;
+        auto up = gradient();
+        fa = a - dp;
+        auto dn = gradient();
+        fa = a;
+
+        for (size_t q = 0; q < P; ++q) {
+            REQUIRE( L.FreeAmplitudeHessian[p][q] == L.FreeAmplitudeHessian[q][p] );
+            REQUIRE( L.FreeAmplitudeHessian[p][q] == Approx((up[q] - dn[q]) / 2. / h).epsilon(1.e-4).scale(1.) );
+        }
+    }
+}
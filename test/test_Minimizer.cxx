@@ -0,0 +1,59 @@
+#include <catch.hpp>
+
+#include <Exceptions.h>
+#include <LogLikelihood.h>
+#include <MassShapeWithNominalMass.h>
+#include <Minimizer.h>
+#include <Model.h>
+#include <ModelIntegral.h>
+#include <Parameter.h>
+
+#include "helperFunctions.h"
+
+#include <cmath>
+#include <complex>
+#include <memory>
+
+TEST_CASE( "Minimizer" )
+{
+    fit_fixture F(200, 400, 2);
+    auto& M = F.M;
+    auto& DP = F.DP;
+    auto& DP_int = F.DP_int;
+    auto& I = F.I;
+
+    auto L_start = log_likelihood(*M, DP, I).Value;
+
+    SECTION( "amplitudes" ) {
+        yap::Minimizer m(*M, DP, I);
+        auto L = m.minimize();
+
+        REQUIRE( m.converged() );
+        REQUIRE( L >= L_start );
+        REQUIRE( L == Approx(sum_of_log_intensity(*M, DP, log(integral(I).value()))) );
+
+        // gradient vanishes at maximum
+        for (const auto& g : log_likelihood(*M, DP, I).FreeAmplitudeGradient)
+            REQUIRE( abs(g) < 1.e-3 );
+
+        // shape parameters need integration partitions
+        REQUIRE_THROWS_AS( m.addParameter(std::make_shared<yap::RealParameter>(1.)), yap::exceptions::Exception );
+    }
+
+    SECTION( "shape parameters" ) {
+        auto bw = mass_shape<yap::MassShapeWithNominalMass>(*M, "rho0");
+        REQUIRE( bw );
+
+        yap::Minimizer m(*M, DP, I, DP_int);
+        m.addParameter(bw->mass(), 0.7, 0.85);
+        REQUIRE_THROWS_AS( m.addParameter(bw->mass()), yap::exceptions::Exception );
+
+        auto L = m.minimize();
+
+        REQUIRE( L >= L_start );
+        REQUIRE( bw->mass()->value() >= 0.7 );
+        REQUIRE( bw->mass()->value() <= 0.85 );
+        REQUIRE_FALSE( I.integrals()[0].Integral.changed() );
+        REQUIRE( L == Approx(sum_of_log_intensity(*M, DP, log(integral(I).value()))) );
+    }
+}
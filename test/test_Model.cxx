@@ -1,14 +1,33 @@
 #include <catch.hpp>
 
+#include <BlattWeisskopf.h>
+#include <BreitWigner.h>
+#include <CalculationGraph.h>
+#include <DataPartition.h>
 #include <DataSet.h>
+#include <DecayChannel.h>
+#include <DecayTree.h>
 #include <Exceptions.h>
+#include <FinalStateParticle.h>
+#include <Flatte.h>
+#include <FourMomenta.h>
+#include <FreeAmplitude.h>
 #include <HelicityFormalism.h>
+#include <ImportanceSampler.h>
 #include <make_unique.h>
+#include <MeasuredBreakupMomenta.h>
 #include <Model.h>
+#include <ModelIntegral.h>
+#include <Parameter.h>
+#include <ParticleCombination.h>
+#include <ParticleTable.h>
+#include <RecalculableDataAccessor.h>
 #include <SpinAmplitudeCache.h>
 
 #include "helperFunctions.h"
 
+#include <set>
+
 TEST_CASE( "Model" )
 {
 
@@ -64,3 +83,217 @@ TEST_CASE( "Model" )
     }
     
 }
+
+TEST_CASE( "Model_calculation_graph" )
+{
+    auto M = std::make_shared<yap::Model>(std::make_unique<yap::HelicityFormalism>());
+
+    auto T = yap::read_pdl_file(find_pdl_file());
+    double radialSize = 3.;
+
+    auto D = yap::DecayingParticle::create(T["D+"], radialSize);
+
+    auto piPlus  = yap::FinalStateParticle::create(T[211]);
+    auto piMinus = yap::FinalStateParticle::create(T[-211]);
+    M->setFinalState(piPlus, piMinus, piPlus);
+
+    // resonances with Breit-Wigner's depending on Blatt-Weisskopf factors
+    auto rho_bw = std::make_shared<yap::BreitWigner>(T["rho0"]);
+    auto rho = yap::DecayingParticle::create(T["rho0"], radialSize, rho_bw);
+    rho->addStrongDecay(piPlus, piMinus);
+
+    auto f_2 = yap::DecayingParticle::create(T["f_2"], radialSize, std::make_shared<yap::BreitWigner>(T["f_2"]));
+    f_2->addStrongDecay(piPlus, piMinus);
+
+    auto f_0 = yap::DecayingParticle::create(T["f_0"], radialSize, std::make_shared<yap::ConstantWidthBreitWigner>(T["f_0"]));
+    f_0->addStrongDecay(piPlus, piMinus);
+
+    D->addWeakDecay(rho, piPlus);
+    D->addWeakDecay(f_2, piPlus);
+    D->addWeakDecay(f_0, piPlus);
+
+    M->lock();
+
+    const auto& G = M->calculationGraph();
+    REQUIRE( G.depth() == 2 );
+
+    // every accessor comes after those it depends on
+    for (auto it = G.order().begin(); it != G.order().end(); ++it)
+        for (const auto& d : (*it)->dependencies())
+            REQUIRE( std::find(G.order().begin(), it, d) != it );
+
+    REQUIRE( std::find(G.order().begin(), G.order().end(), rho_bw.get()) != G.order().end() );
+    REQUIRE( rho_bw->dependencies().size() == 1 );
+
+    auto D_serial = generate_data(*M, 200);
+    auto D_threaded = generate_data(*M, 200);
+
+    REQUIRE( sum_of_log_intensity(*M, D_threaded, 0, 4) == Approx(sum_of_log_intensity(*M, D_serial)) );
+
+    // recalculate after a change to a mass shape
+    rho_bw->mass()->setValue(0.8);
+    REQUIRE( sum_of_log_intensity(*M, D_threaded, 0, 4) == Approx(sum_of_log_intensity(*M, D_serial)) );
+    M->setParameterFlagsToUnchanged();
+
+    for (size_t i = 0; i < D_serial.size(); ++i)
+        REQUIRE( D_threaded[i] == D_serial[i] );
+}
+
+TEST_CASE( "Model_parameter_generations" )
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+
+    auto bw = mass_shape<yap::ConstantWidthBreitWigner>(*M, "rho0");
+    REQUIRE( bw );
+
+    auto D = generate_data(*M, 100);
+    auto L = sum_of_log_intensity(*M, D);
+    REQUIRE( D.generation(*bw) == bw->generation() );
+
+    yap::ModelIntegral I(*M);
+    REQUIRE( I.integrals()[0].Integral.changed() );
+    auto DP = yap::DataPartitionBlock::create(D, 2);
+    yap::ImportanceSampler::calculate(I, DP);
+    REQUIRE_FALSE( I.integrals()[0].Integral.changed() );
+
+    // setting the same value is no change
+    auto g = bw->generation();
+    auto g_mass = bw->mass()->generation();
+    bw->mass()->setValue(bw->mass()->value());
+    REQUIRE( bw->mass()->generation() == g_mass );
+    REQUIRE( bw->generation() == g );
+
+    // change is pushed to accessor, and from it to integral
+    bw->mass()->setValue(0.8);
+    REQUIRE( bw->mass()->generation() == g_mass + 1 );
+    REQUIRE( bw->generation() == g + 1 );
+    REQUIRE( I.integrals()[0].Integral.changed() );
+
+    // recalculated without resetting parameter flags
+    auto L2 = sum_of_log_intensity(*M, D);
+    REQUIRE( L2 != Approx(L) );
+    REQUIRE( D.generation(*bw) == bw->generation() );
+    REQUIRE( sum_of_log_intensity(*M, D) == Approx(L2) );
+    auto D_fresh = generate_data(*M, 100);
+    REQUIRE( sum_of_log_intensity(*M, D_fresh) == Approx(L2) );
+
+    delete_partitions(DP);
+}
+
+TEST_CASE( "MassShape_batches" )
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+
+    auto bw = mass_shape<yap::ConstantWidthBreitWigner>(*M, "rho0");
+    REQUIRE( bw );
+
+    // more than two full batches, with a partial last batch
+    auto D = generate_data(*M, 2 * yap::MassShape::batch_size + 17);
+    sum_of_log_intensity(*M, D);
+
+    auto m = bw->mass()->value();
+    auto w = bw->width()->value();
+
+    for (const auto& d : D)
+        for (const auto& pc_si : bw->symmetrizationIndices()) {
+            auto T = m * w / (m * m - M->fourMomenta()->m2(d, pc_si.first) - std::complex<double>(0, m * w));
+            REQUIRE( std::real(bw->value(d, pc_si.first)) == Approx(std::real(T)) );
+            REQUIRE( std::imag(bw->value(d, pc_si.first)) == Approx(std::imag(T)) );
+        }
+}
+
+TEST_CASE( "Flatte_batches" )
+{
+    auto M = std::make_shared<yap::Model>(std::make_unique<yap::HelicityFormalism>());
+
+    auto T = yap::read_pdl_file(find_pdl_file());
+    double radialSize = 3.;
+
+    auto D = yap::DecayingParticle::create(T["D+"], radialSize);
+
+    auto piPlus  = yap::FinalStateParticle::create(T[211]);
+    auto piMinus = yap::FinalStateParticle::create(T[-211]);
+    M->setFinalState(piPlus, piMinus, piPlus);
+
+    // pi pi channel is open, K K channel is closed over much of phase space
+    auto flatte = std::make_shared<yap::Flatte>(0.965);
+    flatte->add(yap::FlatteChannel(0.406, *piPlus, *piMinus));
+    flatte->add(yap::FlatteChannel(0.406 * 2, T[321], T[-321]));
+    auto f_0 = yap::DecayingParticle::create(T["f_0"], radialSize, flatte);
+    f_0->addStrongDecay(piPlus, piMinus);
+    D->addWeakDecay(f_0, piPlus);
+
+    M->lock();
+
+    auto data = generate_data(*M, yap::MassShape::batch_size + 17);
+    sum_of_log_intensity(*M, data);
+
+    // per-event calculation
+    auto ws = [&](double s) {
+        std::complex<double> w = 0;
+        for (const auto& fc : flatte->channels())
+            w += fc.Coupling->value() * std::sqrt(std::complex<double>(yap::measured_breakup_momenta::q2(s, fc.Particles[0]->mass(), fc.Particles[1]->mass())));
+        return w;
+    };
+    auto m2 = pow(flatte->mass()->value(), 2);
+    auto w_o_m = 2. * ws(m2) / flatte->mass()->value();
+
+    for (const auto& d : data)
+        for (const auto& pc_si : flatte->symmetrizationIndices()) {
+            auto s = M->fourMomenta()->m2(d, pc_si.first);
+            auto A = w_o_m / (m2 - s - std::complex<double>(0, 2.) * ws(s) / sqrt(s));
+            REQUIRE( std::real(flatte->value(d, pc_si.first)) == Approx(std::real(A)) );
+            REQUIRE( std::imag(flatte->value(d, pc_si.first)) == Approx(std::imag(A)) );
+        }
+}
+
+TEST_CASE( "MeasuredBreakupMomenta" )
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 20);
+
+    const auto& fm = *M->fourMomenta();
+    const auto& mbm = *M->measuredBreakupMomenta();
+
+    // stores only two-body particle combinations, including the initial state's
+    REQUIRE_FALSE( mbm.symmetrizationIndices().empty() );
+    for (const auto& pc_si : mbm.symmetrizationIndices())
+        REQUIRE( pc_si.first->daughters().size() == 2 );
+
+    for (const auto& d : D)
+        for (const auto& pc_si : mbm.symmetrizationIndices()) {
+            const auto& pc = pc_si.first;
+            auto q2 = yap::measured_breakup_momenta::q2(fm.m2(d, pc), fm.m(d, pc->daughters()[0]), fm.m(d, pc->daughters()[1]));
+            REQUIRE( mbm.q2(d, pc) == Approx(q2) );
+            REQUIRE( mbm.q(d, pc) == Approx(sqrt(q2)) );
+        }
+}
+
+TEST_CASE( "SpinAmplitude_indices" )
+{
+    auto M = d3pi<yap::HelicityFormalism>();
+    auto D = generate_data(*M, 10);
+    sum_of_log_intensity(*M, D);
+
+    for (const auto& fa : free_amplitudes(*M)) {
+        const auto& sa = *fa->spinAmplitude();
+
+        // amplitude indices are dense and unique
+        std::set<unsigned> indices;
+        for (auto two_M : sa.twoM())
+            for (const auto& two_m : sa.twoM(two_M))
+                REQUIRE( indices.insert(sa.amplitudeIndex(two_M, two_m)).second );
+        REQUIRE( !indices.empty() );
+        REQUIRE( *indices.rbegin() + 1 == indices.size() );
+    }
+
+    // decay trees resolve the same indices as their spin projections
+    for (const auto& mc : M->components())
+        for (const auto& dt : mc.decayTrees()) {
+            const auto& sa = *dt->freeAmplitude()->spinAmplitude();
+            REQUIRE( dt->amplitudeIndex() == sa.amplitudeIndex(dt->initialTwoM(), dt->finalTwoM()) );
+            for (const auto& d : D)
+                for (const auto& pc : dt->freeAmplitude()->decayChannel()->particleCombinations())
+                    REQUIRE( sa.amplitude(d, pc, dt->amplitudeIndex()) == sa.amplitude(d, pc, dt->initialTwoM(), dt->finalTwoM()) );
+        }
+}
@@ -1,11 +1,15 @@
 #include <catch.hpp>
 
+#include <CachedValue.h>
+#include <DataAccessor.h>
+#include <Model.h>
 #include <ParticleCombination.h>
 #include <ParticleCombinationCache.h>
 
 #include "helperFunctions.h"
 
 #include <memory>
+#include <set>
 
 TEST_CASE( "ParticleCombination" )
 {
@@ -19,3 +23,32 @@ TEST_CASE( "ParticleCombination" )
         REQUIRE_NOTHROW(yap::to_string_with_parent(*pc.lock()));
     }
 }
+
+TEST_CASE( "ParticleCombination_indices" )
+{
+    auto M = d4pi();
+
+    // locked model's particle combinations have dense, unique indices
+    std::set<int> indices;
+    for (const auto& wpc : M->particleCombinationCache()) {
+        auto pc = wpc.lock();
+        if (!pc)
+            continue;
+        REQUIRE( pc->index() >= 0 );
+        REQUIRE( indices.insert(pc->index()).second );
+    }
+    REQUIRE( *indices.rbegin() + 1 == (int)indices.size() );
+
+    // symmetrization indices by particle combination match those in map,
+    // and columns of cached values are laid out like DataColumns
+    unsigned column_offset = 0;
+    for (const auto& da : M->dataAccessors()) {
+        REQUIRE( da->columnOffset() == column_offset );
+        column_offset += da->nSymmetrizationIndices() * da->size();
+        for (const auto& pc_si : da->symmetrizationIndices()) {
+            REQUIRE( da->symmetrizationIndex(*pc_si.first) == pc_si.second );
+            for (const auto& c : da->CachedValues())
+                REQUIRE( c->column(pc_si.second) == da->columnOffset() + pc_si.second * da->size() + c->position() );
+        }
+    }
+}
@@ -7,6 +7,7 @@
 #include <WignerD.h>
 
 #include <cmath>
+#include <vector>
 
 void checkDSymmetries(unsigned twoJ, int twoM, int twoN, double alpha, double beta, double gamma)
 {
@@ -130,3 +131,23 @@ TEST_CASE( "WignerD" )
         }
     }
 }
+
+TEST_CASE( "dMatrix" )
+{
+    // disable debug logs in test
+    yap::disableLogs(el::Level::Debug);
+
+    std::vector<double> betas = {0., 0.3, 1., 2.2, yap::pi(), -1.4};
+
+    for (unsigned twoJ = 0; twoJ <= 6; ++twoJ) {
+        std::vector<double> d((twoJ + 1) * (twoJ + 1) * betas.size());
+        yap::dMatrix::calculate(twoJ, betas.data(), betas.size(), d.data());
+
+        for (int twoM = -twoJ; twoM <= (int)twoJ; twoM += 2)
+            for (int twoN = -twoJ; twoN <= (int)twoJ; twoN += 2)
+                for (size_t i = 0; i < betas.size(); ++i)
+                    REQUIRE( d[yap::dMatrix::index(twoJ, twoM, twoN) * betas.size() + i] == Approx(yap::dFunction(twoJ, twoM, twoN, betas[i])) );
+    }
+
+    REQUIRE_THROWS_AS( yap::dMatrix::cache(yap::dMatrix::max_twoJ + 1), yap::exceptions::Exception );
+}